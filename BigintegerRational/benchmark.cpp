@@ -0,0 +1,154 @@
+#include "primality.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//  Использование: benchmark [linear_digits] [quadratic_digits] [rational_digits] [arena_digits]
+//  Размеры идут степенями 10 от 1 до указанного предела для каждой группы операций
+
+size_t allocations = 0;
+
+void* operator new(size_t size) {
+  ++allocations;
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+  ++allocations;
+  size_t alignment = static_cast<size_t>(align);
+  if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+const double MIN_SECONDS = 0.2;
+const size_t ARENA_BYTES = 16 << 20;
+alignas(std::max_align_t) char arena_buffer[ARENA_BYTES];
+const size_t MAX_ITERATIONS = 1000000;
+size_t sink = 0;
+
+std::string randomDigits(size_t length, unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> digit(0, 9), leading(1, 9);
+  std::string num(1, static_cast<char>('0' + leading(generator)));
+  for (size_t i = 1; i < length; ++i) {
+    num += static_cast<char>('0' + digit(generator));
+  }
+  return num;
+}
+
+//  Время берётся на целую пачку вызовов, пачки растут вдвое: на быстрых
+//  линейных операциях Clock::now() на каждой итерации заметно искажал замер
+template <typename Op>
+void measure(const std::string& name, size_t digits, Op op) {
+  using Clock = std::chrono::steady_clock;
+  size_t iterations = 0;
+  size_t batch = 1;
+  size_t start_allocations = allocations;
+  double elapsed = 0;
+  while (elapsed < MIN_SECONDS && iterations < MAX_ITERATIONS) {
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < batch; ++i) {
+      sink += op();
+    }
+    elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+    iterations += batch;
+    batch = std::min(2 * batch, MAX_ITERATIONS - iterations);
+  }
+  double allocs = static_cast<double>(allocations - start_allocations) / iterations;
+  std::printf("%-18s %9zu %16.1f %12.1f %10zu\n", name.c_str(), digits,
+              elapsed * 1e9 / iterations, allocs, iterations);
+}
+
+size_t touch(const BigInteger& b_int) {
+  return static_cast<size_t>(static_cast<bool>(b_int));
+}
+
+size_t touch(const Rational& ratio) {
+  return static_cast<size_t>(ratio != 0);
+}
+
+void benchBigInteger(size_t digits, size_t linear_limit, size_t quadratic_limit) {
+  std::string str1 = randomDigits(digits, 1), str2 = randomDigits(digits, 2);
+  std::string half = randomDigits(std::max<size_t>(1, digits / 2), 3);
+  BigInteger a(str1), b(str2), c(half);
+  if (digits <= linear_limit) {
+    measure("add", digits, [&] { return touch(a + b); });
+    measure("sub", digits, [&] { return touch(a - b); });
+    measure("parse", digits, [&] { return touch(BigInteger(str1)); });
+  }
+  if (digits <= quadratic_limit) {
+    measure("toString", digits, [&] { return a.toString().size(); });
+    measure("mul", digits, [&] { return touch(a * b); });
+    measure("div", digits, [&] { return touch(a / c); });
+    measure("mod", digits, [&] { return touch(a % c); });
+  }
+}
+
+void benchRational(size_t digits) {
+  Rational x = Rational(BigInteger(randomDigits(digits, 4))) / Rational(BigInteger(randomDigits(digits, 5)));
+  Rational y = Rational(BigInteger(randomDigits(digits, 6))) / Rational(BigInteger(randomDigits(digits, 7)));
+  BigInteger a(randomDigits(digits, 8)), b(randomDigits(digits, 9));
+  measure("gcd", digits, [&] { return touch(Primality::gcd(a, b)); });
+  measure("rational_add", digits, [&] { return touch(x + y); });
+  measure("rational_mul", digits, [&] { return touch(x * y); });
+  measure("rational_less", digits, [&] { return static_cast<size_t>(x < y); });
+  measure("rational_decimal", digits, [&] { return x.asDecimal(digits).size(); });
+}
+
+//  Один и тот же цикл с делением и нормализацией Rational: сначала разряды из
+//  кучи, затем из BigInteger::Arena над статическим буфером с reset() после
+//  каждой итерации - память не возвращается в кучу и не запрашивается у неё
+void benchArena(size_t digits) {
+  BigInteger a(randomDigits(digits, 10)), c(randomDigits(std::max<size_t>(1, digits / 2), 11));
+  Rational x = Rational(BigInteger(randomDigits(digits, 12))) / Rational(c);
+  Rational y = Rational(a) / Rational(BigInteger(randomDigits(digits, 13)));
+  auto work = [&] { return touch(a / c) + touch(a % c) + touch(x / y); };
+  measure("div_heap", digits, work);
+  BigInteger::Arena arena(arena_buffer, ARENA_BYTES);
+  measure("div_arena", digits, [&] {
+    size_t res = work();
+    arena.reset();
+    return res;
+  });
+}
+
+int main(int argc, char** argv) {
+  size_t linear_limit = argc > 1 ? std::stoull(argv[1]) : 1000000;
+  size_t quadratic_limit = argc > 2 ? std::stoull(argv[2]) : 10000;
+  size_t rational_limit = argc > 3 ? std::stoull(argv[3]) : 100;
+  size_t arena_limit = argc > 4 ? std::stoull(argv[4]) : 100;
+  std::printf("%-18s %9s %16s %12s %10s\n", "op", "digits", "ns/op", "allocs/op", "iters");
+  size_t max_limit = std::max({linear_limit, quadratic_limit, rational_limit, arena_limit});
+  for (size_t digits = 1; digits <= max_limit; digits *= 10) {
+    benchBigInteger(digits, linear_limit, quadratic_limit);
+    if (digits <= rational_limit) {
+      benchRational(digits);
+    }
+    if (digits <= arena_limit) {
+      benchArena(digits);
+    }
+  }
+  return sink == 42 ? 1 : 0;
+}
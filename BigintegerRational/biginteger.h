@@ -1,19 +1,25 @@
 #include <cmath>
 #include <cstring>
 #include <iostream>
+#include <memory_resource>
+#include <stdexcept>
 #include <vector>
 
 class BigInteger {
  private:
   static const int BASE = 10000000;
   static const int BASE_STEP = 7;
+  static const size_t LIMB_BYTES = 4;
+  static const size_t HEADER_BYTES = 5;
   enum class Sign {
     NEG = -1,
     ZER = 0,
     POS = 1
   };
+  using Limbs = std::pmr::vector<long long>;
   Sign sign_ = Sign::ZER; 
-  std::vector<long long> digits_;
+  Limbs digits_ = Limbs(currentResource_());
+  static std::pmr::memory_resource*& currentResource_();
   void nullify_();
   bool lessAbs_(const BigInteger& other) const;
   void reverseSign_();
@@ -23,12 +29,31 @@ class BigInteger {
   bool isZero_() const;
   bool isNegative_() const;
   void removeLeadingZeros_();
-  static void add(std::vector<long long>& digits1, const std::vector<long long>& digits2);
-  static std::vector<long long> substract(std::vector<long long> digits1, 
-                                          const std::vector<long long>& digits2);
-  static void multiply(std::vector<long long>& digits1, const std::vector<long long>& digits2);
+  static void add(Limbs& digits1, const Limbs& digits2);
+  static Limbs substract(const Limbs& digits1, const Limbs& digits2);
+  static void multiply(Limbs& digits1, const Limbs& digits2);
+  static void addShort(Limbs& digits, long long num);
+  static void substractShort(Limbs& digits, long long num);
+  static void multiplyShort(Limbs& digits, long long num);
+  static long long divideShort(Limbs& digits, long long num);
+  static bool isShort(long long num);
+  static void writeWord_(char* out, unsigned long word);
+  static unsigned long readWord_(const char* in);
 
  public:
+  class Arena {
+   private:
+    std::pmr::monotonic_buffer_resource buffer_;
+    std::pmr::memory_resource* previous_;
+
+   public:
+    Arena();
+    Arena(void* buffer, size_t size);
+    ~Arena();
+    Arena(const Arena& other) = delete;
+    Arena& operator=(const Arena& other) = delete;
+    void reset();
+  };
   BigInteger(long long num);
   BigInteger(const std::string& num);
   BigInteger();
@@ -40,6 +65,12 @@ class BigInteger {
   BigInteger& operator/=(const BigInteger &other);
   BigInteger operator/(const BigInteger &other) const;
   BigInteger& operator%=(const BigInteger &other);
+  BigInteger& operator+=(long long num);
+  BigInteger& operator-=(long long num);
+  BigInteger& operator*=(long long num);
+  BigInteger& operator/=(long long num);
+  BigInteger operator/(long long num) const;
+  BigInteger& operator%=(long long num);
   bool operator==(const BigInteger& other) const;
   bool operator!=(const BigInteger& other) const;
   bool operator<(const BigInteger& other) const;
@@ -52,6 +83,14 @@ class BigInteger {
   BigInteger& operator--();
   BigInteger operator--(int);
   std::string toString() const;
+  static long long limbBase();
+  size_t limbCount() const;
+  long long limb(size_t index) const;
+  size_t decimalLength() const;
+  BigInteger shiftLimbs(long long count) const;
+  size_t binarySize() const;
+  char* writeBinary(char* out) const;
+  static BigInteger readBinary(const char*& in, const char* end);
   explicit operator bool() const;
   explicit operator int() const;
 };
@@ -81,6 +120,10 @@ class Rational {
   bool operator<=(const Rational& other) const;
   std::string toString() const;
   std::string asDecimal(size_t precision) const;
+  size_t binarySize() const;
+  char* writeBinary(char* out) const;
+  static Rational readBinary(const char*& in, const char* end,
+                             bool checkReduced = false);
   explicit operator double() const;
 };
 
@@ -128,7 +171,7 @@ BigInteger::BigInteger(const std::string& num) {
   }
 }
 
-BigInteger::BigInteger() : sign_(Sign::ZER), digits_(1, 0){};
+BigInteger::BigInteger() : sign_(Sign::ZER), digits_(1, 0, currentResource_()){};
 
 void BigInteger::shift_() {
   if (digits_.empty()) {
@@ -142,7 +185,8 @@ void BigInteger::shift_() {
   digits_[0] = 0;
 }
 
-BigInteger::BigInteger(const BigInteger& other) = default;
+BigInteger::BigInteger(const BigInteger& other)
+    : sign_(other.sign_), digits_(other.digits_, currentResource_()) {}
 
 BigInteger& BigInteger::operator=(const BigInteger& other) = default;
 
@@ -247,7 +291,7 @@ void BigInteger::removeLeadingZeros_() {
   }
 }
 
-void BigInteger::add(std::vector<long long>& digits1, const std::vector<long long>& digits2) {
+void BigInteger::add(Limbs& digits1, const Limbs& digits2) {
   digits1.resize(std::max(digits1.size(), digits2.size()) + 1);
   for (size_t i = 0; i < digits2.size(); ++i) {
     digits1[i] += digits2[i];
@@ -257,15 +301,15 @@ void BigInteger::add(std::vector<long long>& digits1, const std::vector<long lon
     digits1[i] %= BASE;
   }
   size_t i = digits2.size();
-  while (digits1[i] > BASE) {
+  while (digits1[i] >= BASE) {
     digits1[i + 1] += digits1[i] / BASE;
     digits1[i] %= BASE;
     ++i;
   }
 }
 
-std::vector<long long> BigInteger::substract(std::vector<long long> digits1, 
-                                             const std::vector<long long>& digits2) {
+BigInteger::Limbs BigInteger::substract(const Limbs& other_digits1, const Limbs& digits2) {
+  Limbs digits1(other_digits1, currentResource_());
   digits1.resize(std::max(digits1.size(), digits2.size()) + 1);
   for (size_t i = 0; i < digits2.size(); ++i) {
     digits1[i] -= digits2[i];
@@ -285,19 +329,161 @@ std::vector<long long> BigInteger::substract(std::vector<long long> digits1,
   return digits1;
 }
 
-void BigInteger::multiply(std::vector<long long>& digits1, const std::vector<long long>& digits2) {
-  std::vector<long long> res;
-  res.resize(digits1.size() + digits2.size() + 1);
+void BigInteger::multiply(Limbs& digits1, const Limbs& digits2) {
+  Limbs res(digits1.size() + digits2.size() + 1, 0, currentResource_());
   for (size_t i = 0; i < digits1.size(); ++i) {
     for (size_t j = 0; j < digits2.size(); ++j) {
       res[i + j] += digits1[i] * digits2[j];
     }
   }
-  for (size_t i = 0; i < res.size(); ++i) {
+  for (size_t i = 0; i + 1 < res.size(); ++i) {
     res[i + 1] += res[i] / BASE;
     res[i] %= BASE;
   }
-  digits1 = res;
+  digits1 = std::move(res);
+}
+
+//  Короткие операции: второй операнд по модулю меньше BASE, один проход без временного BigInteger
+bool BigInteger::isShort(long long num) {
+  return num > -BASE && num < BASE;
+}
+
+void BigInteger::addShort(Limbs& digits, long long num) {
+  digits[0] += num;
+  for (size_t i = 0; digits[i] >= BASE; ++i) {
+    digits[i] -= BASE;
+    if (i + 1 == digits.size()) {
+      digits.push_back(0);
+    }
+    ++digits[i + 1];
+  }
+}
+
+void BigInteger::substractShort(Limbs& digits, long long num) {
+  digits[0] -= num;
+  for (size_t i = 0; digits[i] < 0; ++i) {
+    digits[i] += BASE;
+    --digits[i + 1];
+  }
+  if (digits.size() > 1 && digits.back() == 0) {
+    digits.pop_back();
+  }
+}
+
+void BigInteger::multiplyShort(Limbs& digits, long long num) {
+  long long carry = 0;
+  for (long long& digit : digits) {
+    digit = digit * num + carry;
+    carry = digit / BASE;
+    digit %= BASE;
+  }
+  while (carry > 0) {
+    digits.push_back(carry % BASE);
+    carry /= BASE;
+  }
+}
+
+long long BigInteger::divideShort(Limbs& digits, long long num) {
+  long long rem = 0;
+  for (int i = static_cast<int>(digits.size()) - 1; i >= 0; --i) {
+    long long cur = rem * BASE + digits[i];
+    digits[i] = cur / num;
+    rem = cur % num;
+  }
+  while (digits.size() > 1 && digits.back() == 0) {
+    digits.pop_back();
+  }
+  return rem;
+}
+
+BigInteger& BigInteger::operator+=(long long num) {
+  if (!isShort(num)) {
+    return *this += BigInteger(num);
+  }
+  if (num == 0) {
+    return *this;
+  }
+  Sign num_sign = (num > 0 ? Sign::POS : Sign::NEG);
+  long long num_abs = (num > 0 ? num : -num);
+  if (isZero_()) {
+    digits_[0] = num_abs;
+    sign_ = num_sign;
+  } else if (sign_ == num_sign) {
+    addShort(digits_, num_abs);
+  } else if (size_() > 1 || digits_[0] > num_abs) {
+    substractShort(digits_, num_abs);
+  } else if (digits_[0] == num_abs) {
+    nullify_();
+  } else {
+    digits_[0] = num_abs - digits_[0];
+    reverseSign_();
+  }
+  return *this;
+}
+
+BigInteger& BigInteger::operator-=(long long num) {
+  if (!isShort(num)) {
+    return *this -= BigInteger(num);
+  }
+  return *this += -num;
+}
+
+BigInteger& BigInteger::operator*=(long long num) {
+  if (!isShort(num)) {
+    return *this *= BigInteger(num);
+  }
+  if (isZero_()) {
+    return *this;
+  }
+  if (num == 0) {
+    nullify_();
+    return *this;
+  }
+  if (num < 0) {
+    reverseSign_();
+    num = -num;
+  }
+  multiplyShort(digits_, num);
+  return *this;
+}
+
+BigInteger& BigInteger::operator/=(long long num) {
+  if (num == 0 || !isShort(num)) {
+    return *this /= BigInteger(num);
+  }
+  if (isZero_()) {
+    return *this;
+  }
+  if (num < 0) {
+    reverseSign_();
+    num = -num;
+  }
+  divideShort(digits_, num);
+  if (size_() == 1 && digits_[0] == 0) {
+    nullify_();
+  }
+  return *this;
+}
+
+BigInteger BigInteger::operator/(long long num) const {
+  BigInteger tmp = *this;
+  return tmp /= num;
+}
+
+BigInteger& BigInteger::operator%=(long long num) {
+  if (num == 0 || !isShort(num)) {
+    return *this %= BigInteger(num);
+  }
+  if (isZero_()) {
+    return *this;
+  }
+  long long rem = divideShort(digits_, num > 0 ? num : -num);
+  digits_.resize(1);
+  digits_[0] = rem;
+  if (rem == 0) {
+    nullify_();
+  }
+  return *this;
 }
 
 BigInteger& BigInteger::operator+=(const BigInteger& other) {
@@ -383,13 +569,40 @@ BigInteger operator*(const BigInteger& b_int1, const BigInteger& b_int2) {
   return tmp *= b_int2;
 }
 
+BigInteger operator+(const BigInteger& b_int, long long num) {
+  BigInteger tmp = b_int;
+  return tmp += num;
+}
+
+BigInteger operator-(const BigInteger& b_int, long long num) {
+  BigInteger tmp = b_int;
+  return tmp -= num;
+}
+
+BigInteger operator*(const BigInteger& b_int, long long num) {
+  BigInteger tmp = b_int;
+  return tmp *= num;
+}
+
+BigInteger operator*(long long num, const BigInteger& b_int) {
+  BigInteger tmp = b_int;
+  return tmp *= num;
+}
+
+//  Сюда сходятся и деление, и остаток на 0 при любом типе делителя
 BigInteger BigInteger::operator/(const BigInteger& b_int) const {
+  if (b_int.isZero_()) {
+    throw std::domain_error("BigInteger division by zero");
+  }
   if (b_int.size_() > size_() || (lessAbs_(b_int))) {
     return 0;
   }
   if (b_int == *this) {
     return 1;
   }
+  if (b_int.size_() == 1) {
+    return *this / (b_int.isNegative_() ? -b_int.digits_[0] : b_int.digits_[0]);
+  }
   BigInteger result, tmp, copy = b_int;
   copy.sign_ = Sign::POS;
   result.digits_.resize(size_());
@@ -420,6 +633,9 @@ BigInteger BigInteger::operator/(const BigInteger& b_int) const {
 }
 
 BigInteger& BigInteger::operator%=(const BigInteger& other) {
+  if (other.size_() == 1 && !other.isZero_()) {
+    return *this %= (other.isNegative_() ? -other.digits_[0] : other.digits_[0]);
+  }
   BigInteger tmp = other;
   return *this -= other * (*this / tmp);
 }
@@ -429,6 +645,11 @@ BigInteger operator%(const BigInteger& b_int1, const BigInteger& b_int2) {
   return tmp %= b_int2; 
 }
 
+BigInteger operator%(const BigInteger& b_int, long long num) {
+  BigInteger tmp = b_int;
+  return tmp %= num;
+}
+
 BigInteger& BigInteger::operator++() {
   *this += 1;
   return *this;
@@ -463,6 +684,31 @@ BigInteger::operator int() const {
   return res;
 }
 
+std::pmr::memory_resource*& BigInteger::currentResource_() {
+  thread_local std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+  return resource;
+}
+
+//  Пока арена жива, все новые числа этого потока берут разряды из неё, а память
+//  возвращается только целиком в reset(); значения, созданные внутри, нельзя
+//  использовать после reset() или выхода из области видимости
+BigInteger::Arena::Arena() : previous_(currentResource_()) {
+  currentResource_() = &buffer_;
+}
+
+BigInteger::Arena::Arena(void* buffer, size_t size)
+    : buffer_(buffer, size), previous_(currentResource_()) {
+  currentResource_() = &buffer_;
+}
+
+BigInteger::Arena::~Arena() {
+  currentResource_() = previous_;
+}
+
+void BigInteger::Arena::reset() {
+  buffer_.release();
+}
+
 void BigInteger::nullify_() {
   sign_ = Sign::ZER;
   digits_.clear();
@@ -510,6 +756,120 @@ std::string BigInteger::toString() const {
   return res;
 }
 
+//  Прямой доступ к разрядам модуля по основанию limbBase(), младший первым:
+//  без перевода в десятичную строку
+long long BigInteger::limbBase() {
+  return BASE;
+}
+
+size_t BigInteger::limbCount() const {
+  return size_();
+}
+
+long long BigInteger::limb(size_t index) const {
+  return digits_[index];
+}
+
+size_t BigInteger::decimalLength() const {
+  size_t length = (size_() - 1) * BASE_STEP;
+  for (long long top = digits_[size_() - 1]; top > 0; top /= 10) {
+    ++length;
+  }
+  return std::max<size_t>(length, 1);
+}
+
+//  Умножение (count > 0) или деление с отбрасыванием остатка (count < 0) на
+//  limbBase()^|count| сдвигом разрядов; знак сохраняется
+BigInteger BigInteger::shiftLimbs(long long count) const {
+  if (isZero_() || count == 0) {
+    return *this;
+  }
+  size_t amount = static_cast<size_t>(count > 0 ? count : -count);
+  if (count < 0 && amount >= size_()) {
+    return BigInteger();
+  }
+  BigInteger res;
+  res.sign_ = sign_;
+  if (count > 0) {
+    res.digits_.assign(amount, 0);
+    res.digits_.insert(res.digits_.end(), digits_.begin(), digits_.end());
+  } else {
+    res.digits_.assign(digits_.begin() + amount, digits_.end());
+  }
+  return res;
+}
+
+//  Двоичный формат: байт знака (-1, 0, 1), число разрядов и сами разряды
+//  по LIMB_BYTES байт в little-endian, младший разряд первым; у нуля разрядов нет
+void BigInteger::writeWord_(char* out, unsigned long word) {
+  for (size_t i = 0; i < LIMB_BYTES; ++i) {
+    out[i] = static_cast<char>((word >> (8 * i)) & 0xFF);
+  }
+}
+
+unsigned long BigInteger::readWord_(const char* in) {
+  unsigned long word = 0;
+  for (size_t i = 0; i < LIMB_BYTES; ++i) {
+    word |= static_cast<unsigned long>(static_cast<unsigned char>(in[i])) << (8 * i);
+  }
+  return word;
+}
+
+size_t BigInteger::binarySize() const {
+  return HEADER_BYTES + (isZero_() ? 0 : size_() * LIMB_BYTES);
+}
+
+char* BigInteger::writeBinary(char* out) const {
+  out[0] = static_cast<char>(static_cast<int>(sign_));
+  if (isZero_()) {
+    writeWord_(out + 1, 0);
+    return out + HEADER_BYTES;
+  }
+  writeWord_(out + 1, size_());
+  out += HEADER_BYTES;
+  for (size_t i = 0; i < size_(); ++i) {
+    writeWord_(out, digits_[i]);
+    out += LIMB_BYTES;
+  }
+  return out;
+}
+
+//  Разбирает буфер (например, отображённый в память файл) и сдвигает in;
+//  разряды копируются в собственный вектор числа, буфер можно освобождать
+BigInteger BigInteger::readBinary(const char*& in, const char* end) {
+  if (end - in < static_cast<ptrdiff_t>(HEADER_BYTES)) {
+    throw std::invalid_argument("Truncated BigInteger binary data");
+  }
+  int sign = static_cast<signed char>(in[0]);
+  size_t count = readWord_(in + 1);
+  if (sign < -1 || sign > 1 || (sign == 0) != (count == 0)) {
+    throw std::invalid_argument("Malformed BigInteger binary header");
+  }
+  if (static_cast<size_t>(end - in - HEADER_BYTES) / LIMB_BYTES < count) {
+    throw std::invalid_argument("Truncated BigInteger binary data");
+  }
+  //  in сдвигается только после успешного чтения всего числа
+  const char* cursor = in + HEADER_BYTES;
+  BigInteger res;
+  if (sign != 0) {
+    res.sign_ = static_cast<Sign>(sign);
+    res.digits_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      unsigned long digit = readWord_(cursor);
+      if (digit >= static_cast<unsigned long>(BASE)) {
+        throw std::invalid_argument("Malformed BigInteger binary digit");
+      }
+      res.digits_[i] = digit;
+      cursor += LIMB_BYTES;
+    }
+    if (res.digits_.back() == 0) {
+      throw std::invalid_argument("Malformed BigInteger binary digit");
+    }
+  }
+  in = cursor;
+  return res;
+}
+
 BigInteger operator""_bi(unsigned long long num) {
   BigInteger res(num);
   return res;
@@ -703,6 +1063,35 @@ std::string Rational::asDecimal(size_t precision) const {
   return res;
 }
 
+size_t Rational::binarySize() const {
+  return numerator_.binarySize() + denomerator_.binarySize();
+}
+
+char* Rational::writeBinary(char* out) const {
+  return denomerator_.writeBinary(numerator_.writeBinary(out));
+}
+
+//  writeBinary пишет только несократимые дроби, и им читатель доверяет: gcd_
+//  на каждое значение дороже самого разбора. Для чужих данных checkReduced
+//  отвергает несокращённую пару (на несократимость опирается operator==);
+//  in сдвигается только при успехе
+Rational Rational::readBinary(const char*& in, const char* end,
+                              bool checkReduced) {
+  const char* cursor = in;
+  Rational res;
+  res.numerator_ = BigInteger::readBinary(cursor, end);
+  res.denomerator_ = BigInteger::readBinary(cursor, end);
+  if (res.denomerator_ <= 0 || (res.numerator_ == 0 && res.denomerator_ != 1)) {
+    throw std::invalid_argument("Malformed Rational binary denominator");
+  }
+  if (checkReduced && res.numerator_ != 0 &&
+      gcd_(res.numerator_, res.denomerator_) != 1) {
+    throw std::invalid_argument("Non-reduced Rational binary data");
+  }
+  in = cursor;
+  return res;
+}
+
 Rational::operator double() const {
   return std::stod(asDecimal(DOUBLE_DIGITS));
 }
\ No newline at end of file
@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "biginteger.h"
+
+namespace Primality {
+  using u64 = unsigned long long;
+  __extension__ typedef unsigned __int128 u128;
+
+  //  Колесо по модулю 30: после 2, 3, 5 проверяем только числа, взаимно простые с 30
+  const u64 WHEEL_START = 7;
+  const u64 WHEEL[] = {4, 2, 4, 2, 4, 6, 2, 6};
+  const size_t WHEEL_SIZE = 8;
+  const u64 WHEEL_PRIMES[] = {2, 3, 5};
+  //  Этих оснований достаточно для детерминированного Миллера-Рабина на всех 64-битных числах
+  const u64 DETERMINISTIC_BASES[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  const u64 TRIAL_LIMIT = 1000;
+  const size_t RANDOM_ROUNDS = 16;
+  const size_t BRENT_BATCH = 128;
+
+  //  64-битный путь: умножение по модулю через 128-битное произведение
+  u64 mulMod(u64 a, u64 b, u64 mod) {
+    return static_cast<u64>(static_cast<u128>(a) * b % mod);
+  }
+
+  u64 addMod(u64 a, u64 b, u64 mod) {
+    return (a >= mod - b) ? a - (mod - b) : a + b;
+  }
+
+  u64 powMod(u64 base, u64 exp, u64 mod) {
+    u64 res = 1 % mod;
+    base %= mod;
+    while (exp > 0) {
+      if (exp & 1) {
+        res = mulMod(res, base, mod);
+      }
+      base = mulMod(base, base, mod);
+      exp >>= 1;
+    }
+    return res;
+  }
+
+  u64 gcd(u64 a, u64 b) {
+    while (b != 0) {
+      a %= b;
+      std::swap(a, b);
+    }
+    return a;
+  }
+
+  //  Значение модуля по разрядам; для чисел больше 128 бит не определено
+  u128 limbsValue(const BigInteger& num) {
+    u128 res = 0;
+    for (size_t i = num.limbCount(); i-- > 0;) {
+      res = res * BigInteger::limbBase() + num.limb(i);
+    }
+    return res;
+  }
+
+  //  Три разряда по 10^7 вмещают до 10^21 > 2^64, четыре уже не нужны
+  bool fitsU64(const BigInteger& num) {
+    if (num < 0) {
+      return false;
+    }
+    return num.limbCount() <= 3 && limbsValue(num) <= ~u64(0);
+  }
+
+  u64 toU64(const BigInteger& num) {
+    return static_cast<u64>(limbsValue(num));
+  }
+
+  BigInteger fromU64(u64 num) {
+    return BigInteger(std::to_string(num));
+  }
+
+  BigInteger normalizedMod(const BigInteger& num, const BigInteger& mod) {
+    BigInteger res = num % mod;
+    if (res < 0) {
+      res += mod;
+    }
+    return res;
+  }
+
+  BigInteger absDiff(const BigInteger& b_int1, const BigInteger& b_int2) {
+    BigInteger res = b_int1 - b_int2;
+    return res < 0 ? -res : res;
+  }
+
+  BigInteger gcd(BigInteger b_int1, BigInteger b_int2) {
+    while (b_int2 != 0) {
+      b_int1 %= b_int2;
+      std::swap(b_int1, b_int2);
+    }
+    return b_int1 < 0 ? -b_int1 : b_int1;
+  }
+
+  //  Редукция Барретта по основанию разрядов b = BigInteger::limbBase(): для
+  //  модуля из k разрядов mu = b^(2k) / n считается одним делением, а каждое
+  //  x mod n при 0 <= x < n^2 сводится к сдвигам, двум умножениям и не более
+  //  чем двум вычитаниям вместо длинного деления
+  class BarrettReducer {
+   public:
+    explicit BarrettReducer(const BigInteger& mod);
+    const BigInteger& mod() const;
+    BigInteger reduce(const BigInteger& num) const;
+    BigInteger mulMod(const BigInteger& a, const BigInteger& b) const;
+    BigInteger subMod(const BigInteger& a, const BigInteger& b) const;
+
+   private:
+    BigInteger mod_;
+    BigInteger mu_;
+    long long limbs_;
+  };
+
+  BarrettReducer::BarrettReducer(const BigInteger& mod)
+      : mod_(mod), limbs_(static_cast<long long>(mod.limbCount())) {
+    mu_ = BigInteger(1).shiftLimbs(2 * limbs_) / mod_;
+  }
+
+  const BigInteger& BarrettReducer::mod() const {
+    return mod_;
+  }
+
+  //  q = ((x / b^(k-1)) * mu) / b^(k+1) занижает x / n не более чем на 2
+  BigInteger BarrettReducer::reduce(const BigInteger& num) const {
+    BigInteger quotient = (num.shiftLimbs(1 - limbs_) * mu_).shiftLimbs(-limbs_ - 1);
+    BigInteger res = num - quotient * mod_;
+    while (res >= mod_) {
+      res -= mod_;
+    }
+    return res;
+  }
+
+  //  a и b уже приведены в [0, n)
+  BigInteger BarrettReducer::mulMod(const BigInteger& a, const BigInteger& b) const {
+    return reduce(a * b);
+  }
+
+  //  a, b в [0, n)
+  BigInteger BarrettReducer::subMod(const BigInteger& a, const BigInteger& b) const {
+    BigInteger res = a - b;
+    if (res < 0) {
+      res += mod_;
+    }
+    return res;
+  }
+
+  BigInteger powMod(BigInteger base, BigInteger exp, const BarrettReducer& reducer) {
+    BigInteger res = 1 % reducer.mod();
+    while (exp > 0) {
+      if (exp % 2 != 0) {
+        res = reducer.mulMod(res, base);
+      }
+      base = reducer.mulMod(base, base);
+      exp /= 2;
+    }
+    return res;
+  }
+
+  BigInteger powMod(BigInteger base, BigInteger exp, const BigInteger& mod) {
+    return powMod(normalizedMod(base, mod), exp, BarrettReducer(mod));
+  }
+
+  BigInteger isqrt(const BigInteger& num) {
+    if (num < 2) {
+      return num;
+    }
+    size_t length = num.decimalLength();
+    BigInteger x("1" + std::string((length + 1) / 2, '0'));
+    while (true) {
+      BigInteger y = (x + num / x) / 2;
+      if (y >= x) {
+        return x;
+      }
+      x = y;
+    }
+  }
+
+  bool isPerfectSquare(const BigInteger& num) {
+    BigInteger root = isqrt(num);
+    return root * root == num;
+  }
+
+  //  Символ Якоби (a / n) для нечётного положительного n
+  int jacobi(BigInteger a, BigInteger n) {
+    a = normalizedMod(a, n);
+    int res = 1;
+    while (a != 0) {
+      while (a % 2 == 0) {
+        a /= 2;
+        BigInteger rem = n % 8;
+        if (rem == 3 || rem == 5) {
+          res = -res;
+        }
+      }
+      std::swap(a, n);
+      if (a % 4 == 3 && n % 4 == 3) {
+        res = -res;
+      }
+      a %= n;
+    }
+    return n == 1 ? res : 0;
+  }
+
+  BigInteger randomBelow(const BigInteger& bound) {
+    static std::mt19937_64 generator(std::random_device{}());
+    std::uniform_int_distribution<int> digit(0, 9), leading(1, 9);
+    std::string num(1, static_cast<char>('0' + leading(generator)));
+    size_t length = bound.decimalLength();
+    for (size_t i = 0; i < length; ++i) {
+      num += static_cast<char>('0' + digit(generator));
+    }
+    return BigInteger(num) % bound;
+  }
+
+  bool millerRabinRound(u64 n, u64 a, u64 d, size_t s) {
+    u64 x = powMod(a, d, n);
+    if (x == 1 || x == n - 1) {
+      return true;
+    }
+    for (size_t r = 1; r < s; ++r) {
+      x = mulMod(x, x, n);
+      if (x == n - 1) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool millerRabinRound(const BarrettReducer& reducer, const BigInteger& a,
+                        const BigInteger& d, size_t s) {
+    const BigInteger& n = reducer.mod();
+    BigInteger x = powMod(normalizedMod(a, n), d, reducer), n_minus_one = n - 1;
+    if (x == 1 || x == n_minus_one) {
+      return true;
+    }
+    for (size_t r = 1; r < s; ++r) {
+      x = reducer.mulMod(x, x);
+      if (x == n_minus_one) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool millerRabin(u64 n) {
+    if (n < 2) {
+      return false;
+    }
+    for (u64 p : DETERMINISTIC_BASES) {
+      if (n % p == 0) {
+        return n == p;
+      }
+    }
+    u64 d = n - 1;
+    size_t s = 0;
+    while (d % 2 == 0) {
+      d /= 2;
+      ++s;
+    }
+    for (u64 a : DETERMINISTIC_BASES) {
+      if (!millerRabinRound(n, a, d, s)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //  Детерминированный для 64-битных n, вероятностный (rounds случайных оснований) для больших
+  bool millerRabin(const BigInteger& n, size_t rounds = RANDOM_ROUNDS) {
+    if (fitsU64(n)) {
+      return millerRabin(toU64(n));
+    }
+    if (n < 0 || n % 2 == 0) {
+      return false;
+    }
+    BigInteger d = n - 1;
+    size_t s = 0;
+    while (d % 2 == 0) {
+      d /= 2;
+      ++s;
+    }
+    BarrettReducer reducer(n);
+    for (size_t i = 0; i < rounds; ++i) {
+      BigInteger a = randomBelow(n - 3) + 2;
+      if (!millerRabinRound(reducer, a, d, s)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //  num в [0, 2 * mod), mod нечётный
+  BigInteger halveMod(BigInteger num, const BigInteger& mod) {
+    if (num >= mod) {
+      num -= mod;
+    }
+    if (num % 2 != 0) {
+      num += mod;
+    }
+    return num / 2;
+  }
+
+  //  Сильный тест Люка с параметрами Селфриджа (метод A): P = 1, Q = (1 - D) / 4.
+  //  Для точного квадрата D с (D / n) = -1 не существует, поэтому квадраты и
+  //  чётные n отсекаются до поиска
+  bool strongLucas(const BarrettReducer& reducer) {
+    const BigInteger& n = reducer.mod();
+    if (n % 2 == 0 || isPerfectSquare(n)) {
+      return n == 2;
+    }
+    long long d = 5;
+    while (true) {
+      int symbol = jacobi(d, n);
+      if (symbol == -1) {
+        break;
+      }
+      if (symbol == 0 && BigInteger(d < 0 ? -d : d) != n) {
+        return false;
+      }
+      d = (d > 0) ? -(d + 2) : -(d - 2);
+    }
+    long long q = (1 - d) / 4;
+    BigInteger k = n + 1;
+    size_t s = 0;
+    while (k % 2 == 0) {
+      k /= 2;
+      ++s;
+    }
+    std::vector<bool> bits;
+    while (k > 0) {
+      bits.push_back(k % 2 != 0);
+      k /= 2;
+    }
+    BigInteger q_mod = normalizedMod(q, n), d_mod = normalizedMod(d, n);
+    BigInteger u = 1, v = 1, q_k = q_mod;
+    auto doubleV = [&reducer](const BigInteger& v, const BigInteger& q_k) {
+      BigInteger twice_q = q_k + q_k;
+      if (twice_q >= reducer.mod()) {
+        twice_q -= reducer.mod();
+      }
+      return reducer.subMod(reducer.mulMod(v, v), twice_q);
+    };
+    for (int i = static_cast<int>(bits.size()) - 2; i >= 0; --i) {
+      u = reducer.mulMod(u, v);
+      v = doubleV(v, q_k);
+      q_k = reducer.mulMod(q_k, q_k);
+      if (bits[i]) {
+        BigInteger next_u = halveMod(u + v, n);
+        v = halveMod(reducer.mulMod(d_mod, u) + v, n);
+        u = next_u;
+        q_k = reducer.mulMod(q_k, q_mod);
+      }
+    }
+    if (u == 0 || v == 0) {
+      return true;
+    }
+    for (size_t r = 1; r < s; ++r) {
+      v = doubleV(v, q_k);
+      if (v == 0) {
+        return true;
+      }
+      q_k = reducer.mulMod(q_k, q_k);
+    }
+    return false;
+  }
+
+  bool strongLucas(const BigInteger& n) {
+    if (n < 2) {
+      return false;
+    }
+    return strongLucas(BarrettReducer(n));
+  }
+
+  bool bailliePSW(const BigInteger& n) {
+    if (n < 2) {
+      return false;
+    }
+    for (u64 p : DETERMINISTIC_BASES) {
+      if (n % p == 0) {
+        return n == p;
+      }
+    }
+    BigInteger d = n - 1;
+    size_t s = 0;
+    while (d % 2 == 0) {
+      d /= 2;
+      ++s;
+    }
+    BarrettReducer reducer(n);
+    if (!millerRabinRound(reducer, 2, d, s)) {
+      return false;
+    }
+    return strongLucas(reducer);
+  }
+
+  bool isPrime(u64 n) {
+    return millerRabin(n);
+  }
+
+  bool isPrime(const BigInteger& n) {
+    if (fitsU64(n)) {
+      return millerRabin(toU64(n));
+    }
+    return bailliePSW(n);
+  }
+
+  //  Делит n на простые до limit по колесу, найденные множители дописывает в factors
+  void trialDivision(u64& n, u64 limit, std::vector<u64>& factors) {
+    for (u64 p : WHEEL_PRIMES) {
+      while (n % p == 0 && n > 1) {
+        factors.push_back(p);
+        n /= p;
+      }
+    }
+    u64 p = WHEEL_START;
+    for (size_t i = 0; p <= limit && p * p <= n; p += WHEEL[i], i = (i + 1) % WHEEL_SIZE) {
+      while (n % p == 0) {
+        factors.push_back(p);
+        n /= p;
+      }
+    }
+  }
+
+  void trialDivision(BigInteger& n, u64 limit, std::vector<BigInteger>& factors) {
+    for (u64 p : WHEEL_PRIMES) {
+      while (n > 1 && n % p == 0) {
+        factors.push_back(p);
+        n /= p;
+      }
+    }
+    u64 p = WHEEL_START;
+    for (size_t i = 0; p <= limit && n >= p * p; p += WHEEL[i], i = (i + 1) % WHEEL_SIZE) {
+      while (n % p == 0) {
+        factors.push_back(p);
+        n /= p;
+      }
+    }
+  }
+
+  //  Ро-метод Полларда в варианте Брента: gcd считается по произведению BRENT_BATCH разностей
+  u64 pollardBrent(u64 n, u64 c) {
+    if (n % 2 == 0) {
+      return 2;
+    }
+    auto f = [n, c](u64 x) { return addMod(mulMod(x, x, n), c, n); };
+    u64 y = 2, x = 2, ys = 2, g = 1, q = 1;
+    for (size_t r = 1; g == 1; r *= 2) {
+      x = y;
+      for (size_t i = 0; i < r; ++i) {
+        y = f(y);
+      }
+      for (size_t k = 0; k < r && g == 1; k += BRENT_BATCH) {
+        ys = y;
+        for (size_t i = 0; i < std::min(BRENT_BATCH, r - k); ++i) {
+          y = f(y);
+          q = mulMod(q, x > y ? x - y : y - x, n);
+        }
+        g = gcd(q, n);
+      }
+    }
+    if (g == n) {
+      do {
+        ys = f(ys);
+        g = gcd(x > ys ? x - ys : ys - x, n);
+      } while (g == 1);
+    }
+    return g;
+  }
+
+  BigInteger pollardBrent(const BigInteger& n, const BigInteger& c) {
+    if (n % 2 == 0) {
+      return 2;
+    }
+    BarrettReducer reducer(n);
+    auto f = [&reducer, &c](const BigInteger& x) {
+      BigInteger res = reducer.mulMod(x, x) + c;
+      return res >= reducer.mod() ? res % reducer.mod() : res;
+    };
+    BigInteger y = 2, x = 2, ys = 2, g = 1, q = 1;
+    for (size_t r = 1; g == 1; r *= 2) {
+      x = y;
+      for (size_t i = 0; i < r; ++i) {
+        y = f(y);
+      }
+      for (size_t k = 0; k < r && g == 1; k += BRENT_BATCH) {
+        ys = y;
+        for (size_t i = 0; i < std::min(BRENT_BATCH, r - k); ++i) {
+          y = f(y);
+          q = reducer.mulMod(q, absDiff(x, y));
+        }
+        g = gcd(q, n);
+      }
+    }
+    if (g == n) {
+      do {
+        ys = f(ys);
+        g = gcd(absDiff(x, ys), n);
+      } while (g == 1);
+    }
+    return g;
+  }
+
+  void factorizeInto(u64 n, std::vector<u64>& factors) {
+    if (n == 1) {
+      return;
+    }
+    if (millerRabin(n)) {
+      factors.push_back(n);
+      return;
+    }
+    u64 divisor = n;
+    for (u64 c = 1; divisor == n; ++c) {
+      divisor = pollardBrent(n, c);
+    }
+    factorizeInto(divisor, factors);
+    factorizeInto(n / divisor, factors);
+  }
+
+  void factorizeInto(const BigInteger& n, std::vector<BigInteger>& factors) {
+    if (fitsU64(n)) {
+      std::vector<u64> small;
+      factorizeInto(toU64(n), small);
+      for (u64 factor : small) {
+        factors.push_back(fromU64(factor));
+      }
+      return;
+    }
+    if (isPrime(n)) {
+      factors.push_back(n);
+      return;
+    }
+    BigInteger divisor = n;
+    for (long long c = 1; divisor == n; ++c) {
+      divisor = pollardBrent(n, c);
+    }
+    factorizeInto(divisor, factors);
+    factorizeInto(n / divisor, factors);
+  }
+
+  //  Разложение на простые множители с учётом кратности, по возрастанию; для 0 пусто
+  std::vector<u64> factorize(u64 n) {
+    std::vector<u64> factors;
+    if (n == 0) {
+      return factors;
+    }
+    trialDivision(n, TRIAL_LIMIT, factors);
+    factorizeInto(n, factors);
+    std::sort(factors.begin(), factors.end());
+    return factors;
+  }
+
+  std::vector<BigInteger> factorize(BigInteger n) {
+    std::vector<BigInteger> factors;
+    if (n < 0) {
+      n = -n;
+    }
+    if (n == 0) {
+      return factors;
+    }
+    trialDivision(n, TRIAL_LIMIT, factors);
+    factorizeInto(n, factors);
+    std::sort(factors.begin(), factors.end());
+    return factors;
+  }
+}
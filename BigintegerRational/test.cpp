@@ -0,0 +1,239 @@
+#include "primality.h"
+#include <cassert>
+
+void TestModularArithmetic() {
+  assert(Primality::mulMod(18446744073709551557ull, 18446744073709551556ull,
+                           18446744073709551557ull) == 0);
+  assert(Primality::mulMod(1ull << 63, 4, 1000000007) ==
+         (1ull << 63) % 1000000007 * 4 % 1000000007);
+  assert(Primality::powMod(2, 10, 1000) == 24);
+  assert(Primality::powMod(BigInteger(2), BigInteger(100), BigInteger(1000000007)) ==
+         BigInteger(976371285));
+  assert(Primality::gcd(BigInteger("123456789012345678901234567890"),
+                        BigInteger("987654321098765432109876543210")) ==
+         BigInteger("9000000000900000000090"));
+  assert(Primality::fitsU64(BigInteger("18446744073709551615")));
+  assert(Primality::toU64(BigInteger("18446744073709551615")) == ~0ull);
+  assert(!Primality::fitsU64(BigInteger("18446744073709551616")));
+  assert(!Primality::fitsU64(BigInteger("100000000000000000000000")));
+  assert(Primality::toU64(BigInteger(10000000)) == 10000000);
+  assert(BigInteger("123456789012").decimalLength() == 12);
+  assert(BigInteger(0).decimalLength() == 1);
+}
+
+void TestBarrettReduction() {
+  const char* moduli[] = {"7", "9999991", "10000019", "618970019642690137449562111",
+                          "170141183460469231731687303715884105727"};
+  for (const char* digits : moduli) {
+    BigInteger mod(digits);
+    Primality::BarrettReducer reducer(mod);
+    for (int i = 0; i < 50; ++i) {
+      BigInteger a = Primality::randomBelow(mod), b = Primality::randomBelow(mod);
+      assert(reducer.mulMod(a, b) == a * b % mod);
+      assert(reducer.reduce(mod * mod - 1) == mod - 1);
+      assert(reducer.subMod(a, b) == Primality::normalizedMod(a - b, mod));
+    }
+  }
+}
+
+void TestMillerRabin() {
+  assert(!Primality::millerRabin(0ull));
+  assert(!Primality::millerRabin(1ull));
+  assert(Primality::millerRabin(2ull));
+  assert(Primality::millerRabin(37ull));
+  assert(!Primality::millerRabin(561ull));
+  //  сильное псевдопростое по основаниям 2, 3, 5, 7
+  assert(!Primality::millerRabin(3215031751ull));
+  assert(Primality::millerRabin(2305843009213693951ull));
+  assert(Primality::millerRabin(18446744073709551557ull));
+  assert(!Primality::millerRabin(18446744073709551559ull));
+  assert(Primality::millerRabin(BigInteger("618970019642690137449562111")));
+  assert(!Primality::millerRabin(BigInteger("147573952589676412927")));
+}
+
+void TestBailliePSW() {
+  assert(!Primality::bailliePSW(1));
+  assert(Primality::bailliePSW(2));
+  assert(Primality::bailliePSW(5));
+  assert(!Primality::bailliePSW(9));
+  assert(Primality::bailliePSW(1000000007));
+  assert(!Primality::bailliePSW(3215031751));
+  //  сильное псевдопростое Люка
+  assert(!Primality::bailliePSW(5459));
+  assert(Primality::bailliePSW(BigInteger("618970019642690137449562111")));
+  assert(!Primality::bailliePSW(BigInteger("147573952589676412927")));
+  assert(!Primality::bailliePSW(BigInteger("1000000000000000000000000000049") *
+                                BigInteger("1000000000000000000000000000049")));
+  assert(Primality::isPrime(BigInteger("170141183460469231731687303715884105727")));
+  //  Для квадратов D Селфриджа не существует: strongLucas не должен зацикливаться
+  assert(!Primality::strongLucas(BigInteger(49)));
+  assert(!Primality::strongLucas(BigInteger("1000000000000000000000000000049") *
+                                 BigInteger("1000000000000000000000000000049")));
+  assert(!Primality::strongLucas(BigInteger(1)) && Primality::strongLucas(BigInteger(2)));
+  assert(Primality::strongLucas(BigInteger(1000000007)));
+}
+
+void TestFactorization() {
+  std::vector<unsigned long long> small = Primality::factorize(600851475143ull);
+  assert((small == std::vector<unsigned long long>{71, 839, 1471, 6857}));
+  small = Primality::factorize(1ull << 40);
+  assert(small.size() == 40);
+  small = Primality::factorize(18446744073709551557ull);
+  assert(small.size() == 1);
+  small = Primality::factorize(18446743979220271189ull);
+  assert((small == std::vector<unsigned long long>{4294967279, 4294967291}));
+  std::vector<BigInteger> big = Primality::factorize(BigInteger("147573952589676412927"));
+  assert(big.size() == 2);
+  assert(big[0] == BigInteger(193707721));
+  assert(big[1] == BigInteger("761838257287"));
+  big = Primality::factorize(BigInteger(-360));
+  assert(big.size() == 6);
+  assert(Primality::factorize(BigInteger(0)).empty());
+}
+
+void TestArena() {
+  BigInteger a("98765432109876543210987654321098765432109876543210"), result;
+  char buffer[4096];
+  {
+    BigInteger::Arena arena(buffer, sizeof(buffer));
+    for (int i = 0; i < 10; ++i) {
+      result = a / BigInteger(1234567 + i) + result;
+      arena.reset();
+    }
+  }
+  BigInteger expected;
+  for (int i = 0; i < 10; ++i) {
+    expected += a / BigInteger(1234567 + i);
+  }
+  assert(result == expected);
+  Rational ratio = 1;
+  {
+    BigInteger::Arena arena;
+    Rational tmp = Rational(a) / Rational(BigInteger("12345678901234567890"));
+    ratio = tmp * Rational(BigInteger("12345678901234567890"));
+  }
+  assert(ratio == Rational(a));
+}
+
+void TestBinarySerialization() {
+  std::vector<BigInteger> values = {0, 1, -1, 9999999, 10000000,
+                                    BigInteger("-123456789012345678901234567890")};
+  std::vector<Rational> ratios = {0, Rational(-7) / Rational(3),
+                                  Rational(BigInteger("98765432109876543210")) / Rational(11)};
+  size_t size = 0;
+  for (const BigInteger& value : values) {
+    size += value.binarySize();
+  }
+  for (const Rational& ratio : ratios) {
+    size += ratio.binarySize();
+  }
+  std::vector<char> buffer(size);
+  char* out = buffer.data();
+  for (const BigInteger& value : values) {
+    out = value.writeBinary(out);
+  }
+  for (const Rational& ratio : ratios) {
+    out = ratio.writeBinary(out);
+  }
+  assert(out == buffer.data() + size);
+  const char* in = buffer.data();
+  const char* end = buffer.data() + size;
+  for (const BigInteger& value : values) {
+    assert(BigInteger::readBinary(in, end) == value);
+  }
+  for (const Rational& ratio : ratios) {
+    assert(Rational::readBinary(in, end) == ratio);
+  }
+  assert(in == end);
+  in = buffer.data() + values[0].binarySize() + values[1].binarySize();
+  const char* truncated_end = in + values[2].binarySize() - 1;
+  bool rejected = false;
+  try {
+    BigInteger::readBinary(in, truncated_end);
+  } catch (const std::invalid_argument&) {
+    rejected = true;
+  }
+  assert(rejected && in == buffer.data() + values[0].binarySize() + values[1].binarySize());
+
+  //  Несокращённая дробь 2/4 не читается только с проверкой, дробь с неверным
+  //  знаменателем - никогда; при отказе in остаётся на месте
+  std::vector<char> pair(BigInteger(2).binarySize() + BigInteger(4).binarySize());
+  BigInteger(4).writeBinary(BigInteger(2).writeBinary(pair.data()));
+  in = pair.data();
+  rejected = false;
+  try {
+    Rational::readBinary(in, pair.data() + pair.size(), true);
+  } catch (const std::invalid_argument&) {
+    rejected = true;
+  }
+  assert(rejected && in == pair.data());
+  Rational::readBinary(in, pair.data() + pair.size());
+  assert(in == pair.data() + pair.size());
+  in = pair.data();
+  BigInteger(-4).writeBinary(BigInteger(3).writeBinary(pair.data()));
+  rejected = false;
+  try {
+    Rational::readBinary(in, pair.data() + pair.size());
+  } catch (const std::invalid_argument&) {
+    rejected = true;
+  }
+  assert(rejected && in == pair.data());
+}
+
+void TestShortOperands() {
+  std::vector<BigInteger> values = {0, 1, -1, 9999999, -10000000,
+                                    BigInteger("99999999999999"),
+                                    BigInteger("-100000000000000"),
+                                    BigInteger("123456789012345678901234567890")};
+  std::vector<long long> nums = {1, -1, 2, 7, -10, 9999999, -9999999, 10000000,
+                                 123456789012345ll};
+  for (const BigInteger& value : values) {
+    for (long long num : nums) {
+      assert(value + num == value + BigInteger(num));
+      assert(value - num == value - BigInteger(num));
+      assert(value * num == value * BigInteger(num));
+      assert(num * value == BigInteger(num) * value);
+      BigInteger quotient = value / num, rem = value % num;
+      assert(quotient * BigInteger(num) + rem == value);
+      assert((rem < 0 ? -rem : rem) < (num < 0 ? -num : num));
+      assert(rem == 0 || (rem < 0) == (value < 0));
+    }
+    int thrown = 0;
+    for (int kind = 0; kind < 4; ++kind) {
+      try {
+        switch (kind) {
+          case 0: value / BigInteger(0); break;
+          case 1: value / 0; break;
+          case 2: value % BigInteger(0); break;
+          default: value % 0; break;
+        }
+      } catch (const std::domain_error&) {
+        ++thrown;
+      }
+    }
+    assert(thrown == 4);
+  }
+  BigInteger counter("99999999999999");
+  ++counter;
+  assert(counter == BigInteger("100000000000000"));
+  assert(counter.toString() == "100000000000000");
+  --counter;
+  assert(counter == BigInteger("99999999999999"));
+  assert(BigInteger("123456789012345678901234567890") / 9876543 ==
+         BigInteger("12500000153125003242656"));
+  assert(BigInteger("123456789012345678901234567890") % 9876543 == 3149682);
+  assert(BigInteger("9999999") + BigInteger("99999999999999") ==
+         BigInteger("100000009999998"));
+}
+
+int main() {
+  TestShortOperands();
+  TestModularArithmetic();
+  TestBarrettReduction();
+  TestMillerRabin();
+  TestBailliePSW();
+  TestFactorization();
+  TestArena();
+  TestBinarySerialization();
+  return 0;
+}
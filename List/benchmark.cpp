@@ -0,0 +1,638 @@
+#include "concurrentqueue.h"
+#include "parallellist.h"
+#include "skiplist.h"
+#include "stackallocator.h"
+#include "unrolledlist.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <set>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//  Использование: benchmark [section]
+//  section: allocators, traversal, queue, containers, index, parallel; без аргумента запускаются все разделы
+
+using Clock = std::chrono::steady_clock;
+
+struct Block {
+  Block* previous;
+  Block* next;
+  long long value;
+};
+
+const size_t ALLOCATIONS_PER_THREAD = 250000;
+const size_t MAX_THREADS = 8;
+const size_t SHARED_BYTES = 64 << 20;
+const size_t LOCAL_BYTES = 1 << 20;
+const size_t TRAVERSAL_ELEMENTS = 1 << 20;
+const size_t TRAVERSAL_ROUNDS = 20;
+const size_t TRAVERSAL_BYTES = 64 << 20;
+const size_t QUEUE_ITEMS = 1 << 20;
+const size_t QUEUE_BYTES = 64 << 20;
+const size_t CONTAINER_BYTES = 64 << 20;
+const size_t ELEMENT_OPS = 1 << 20;
+const size_t MIDDLE_INSERTS = 100;
+const size_t INDEX_ELEMENTS = 1 << 18;
+const size_t INDEX_BYTES = 64 << 20;
+const size_t PARALLEL_ELEMENTS = 1 << 20;
+const size_t PARALLEL_BYTES = 64 << 20;
+
+AtomicStackStorage<SHARED_BYTES> shared_storage;
+
+//  Каждый поток делает ALLOCATIONS_PER_THREAD выделений размера узла списка:
+//  work выделяет (замеряется), cleanup освобождает в том же потоке после замера
+double run_threads(size_t threads,
+                   const std::function<void(std::vector<Block*>&)>& work,
+                   const std::function<void(std::vector<Block*>&)>& cleanup) {
+  std::vector<std::vector<Block*>> blocks(threads);
+  std::vector<double> seconds(threads);
+  std::vector<std::thread> workers;
+  for (size_t id = 0; id < threads; ++id) {
+    blocks[id].reserve(ALLOCATIONS_PER_THREAD);
+    workers.emplace_back([&work, &cleanup, &blocks, &seconds, id] {
+      Clock::time_point start = Clock::now();
+      work(blocks[id]);
+      seconds[id] = std::chrono::duration<double>(Clock::now() - start).count();
+      cleanup(blocks[id]);
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  double slowest = *std::max_element(seconds.begin(), seconds.end());
+  return threads * ALLOCATIONS_PER_THREAD / slowest / 1e6;
+}
+
+void bench_allocators() {
+  std::printf("%-24s %8s %14s\n", "allocator", "threads", "Mallocs/s");
+  size_t max_threads = std::min<size_t>(
+      MAX_THREADS, std::max(1u, std::thread::hardware_concurrency()));
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    double std_rate = run_threads(
+        threads,
+        [](std::vector<Block*>& blocks) {
+          std::allocator<Block> allocator;
+          for (size_t i = 0; i < ALLOCATIONS_PER_THREAD; ++i) {
+            blocks.push_back(allocator.allocate(1));
+          }
+        },
+        [](std::vector<Block*>& blocks) {
+          std::allocator<Block> allocator;
+          for (Block* block : blocks) {
+            allocator.deallocate(block, 1);
+          }
+        });
+    std::printf("%-24s %8zu %14.2f\n", "std::allocator", threads, std_rate);
+    shared_storage.reset();
+    double shared_rate = run_threads(
+        threads,
+        [](std::vector<Block*>& blocks) {
+          AtomicStackAllocator<Block, SHARED_BYTES> allocator(shared_storage);
+          for (size_t i = 0; i < ALLOCATIONS_PER_THREAD; ++i) {
+            blocks.push_back(allocator.allocate(1));
+          }
+        },
+        [](std::vector<Block*>&) {});
+    std::printf("%-24s %8zu %14.2f\n", "AtomicStackStorage", threads, shared_rate);
+    double local_rate = run_threads(
+        threads,
+        [](std::vector<Block*>& blocks) {
+          StackAllocator<Block, LOCAL_BYTES> allocator(
+              thread_local_storage<LOCAL_BYTES>());
+          for (size_t i = 0; i < ALLOCATIONS_PER_THREAD; ++i) {
+            blocks.push_back(allocator.allocate(1));
+          }
+        },
+        [](std::vector<Block*>&) {
+          thread_local_storage<LOCAL_BYTES>().reset();
+        });
+    std::printf("%-24s %8zu %14.2f\n", "thread_local_storage", threads, local_rate);
+  }
+}
+
+//  Сумма по контейнеру; возвращает наносекунды на элемент
+template <typename Container>
+double time_traversal(const Container& container, long long& sink) {
+  Clock::time_point start = Clock::now();
+  for (size_t round = 0; round < TRAVERSAL_ROUNDS; ++round) {
+    for (long long value : container) {
+      sink += value;
+    }
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  return seconds * 1e9 / (TRAVERSAL_ROUNDS * container.size());
+}
+
+//  То же через List::accumulate с подгрузкой узлов наперёд
+template <typename Container>
+double time_accumulate(const Container& container, long long& sink) {
+  Clock::time_point start = Clock::now();
+  for (size_t round = 0; round < TRAVERSAL_ROUNDS; ++round) {
+    sink = container.accumulate(sink);
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  return seconds * 1e9 / (TRAVERSAL_ROUNDS * container.size());
+}
+
+//  "shuffled": список после sort по случайным значениям - порядок обхода
+//  больше не совпадает с порядком узлов в памяти, как после долгой работы
+void bench_traversal() {
+  std::mt19937 generator(1);
+  std::vector<long long> values(TRAVERSAL_ELEMENTS);
+  for (long long& value : values) {
+    value = generator();
+  }
+  long long sink = 0;
+  std::printf("%-32s %10s\n", "container", "ns/elem");
+  {
+    List<long long> list;
+    for (long long value : values) {
+      list.push_back(value);
+    }
+    std::printf("%-32s %10.2f\n", "List sequential", time_traversal(list, sink));
+    list.sort();
+    std::printf("%-32s %10.2f\n", "List shuffled", time_traversal(list, sink));
+  }
+  {
+    using Allocator = StackAllocator<long long, TRAVERSAL_BYTES>;
+    auto storage = std::make_unique<StackStorage<TRAVERSAL_BYTES>>();
+    List<long long, Allocator> list{Allocator(*storage)};
+    for (long long value : values) {
+      list.push_back(value);
+    }
+    std::printf("%-32s %10.2f\n", "List+StackAllocator sequential",
+                time_traversal(list, sink));
+    list.sort();
+    std::printf("%-32s %10.2f\n", "List+StackAllocator shuffled",
+                time_traversal(list, sink));
+    std::printf("%-32s %10.2f\n", "  accumulate",
+                time_accumulate(list, sink));
+    list.compact();
+    std::printf("%-32s %10.2f\n", "  after compact()",
+                time_traversal(list, sink));
+  }
+  {
+    UnrolledList<long long, 32> list;
+    for (long long value : values) {
+      list.push_back(value);
+    }
+    std::printf("%-32s %10.2f\n", "UnrolledList<32>", time_traversal(list, sink));
+  }
+  {
+    using Allocator = StackAllocator<long long, TRAVERSAL_BYTES>;
+    auto storage = std::make_unique<StackStorage<TRAVERSAL_BYTES>>();
+    UnrolledList<long long, 32, Allocator> list{Allocator(*storage)};
+    for (long long value : values) {
+      list.push_back(value);
+    }
+    std::printf("%-32s %10.2f\n", "UnrolledList<32>+StackAllocator",
+                time_traversal(list, sink));
+  }
+  std::printf("(checksum %lld)\n", sink);
+}
+
+//  Очередь под внешним мьютексом, как её использовали до ConcurrentQueue
+class LockedList {
+ public:
+  void push(long long value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    list_.push_back(value);
+  }
+  bool try_pop(long long& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (list_.size() == 0) {
+      return false;
+    }
+    value = *list_.begin();
+    list_.pop_front();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  List<long long> list_;
+};
+
+//  pairs производителей и столько же потребителей передают QUEUE_ITEMS
+//  значений; возвращает миллионы переданных элементов в секунду
+template <typename Queue>
+double run_queue(Queue& queue, size_t pairs) {
+  std::atomic<size_t> popped = 0;
+  std::vector<std::thread> workers;
+  Clock::time_point start = Clock::now();
+  for (size_t id = 0; id < pairs; ++id) {
+    workers.emplace_back([&queue, pairs] {
+      for (size_t i = 0; i < QUEUE_ITEMS / pairs; ++i) {
+        queue.push(static_cast<long long>(i));
+      }
+    });
+    workers.emplace_back([&queue, &popped, pairs] {
+      long long value = 0;
+      size_t mine = 0;
+      while (mine < QUEUE_ITEMS / pairs) {
+        if (queue.try_pop(value)) {
+          ++mine;
+        }
+      }
+      popped += mine;
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  return popped / seconds / 1e6;
+}
+
+AtomicStackStorage<QUEUE_BYTES> queue_storage;
+
+void bench_queue() {
+  std::printf("%-32s %8s %14s\n", "queue", "pairs", "Mitems/s");
+  size_t max_pairs = std::min<size_t>(
+      MAX_THREADS / 2, std::max(1u, std::thread::hardware_concurrency() / 2));
+  for (size_t pairs = 1; pairs <= std::max<size_t>(1, max_pairs); pairs *= 2) {
+    {
+      LockedList queue;
+      std::printf("%-32s %8zu %14.2f\n", "mutex + List", pairs,
+                  run_queue(queue, pairs));
+    }
+    {
+      ConcurrentQueue<long long> queue;
+      std::printf("%-32s %8zu %14.2f\n", "ConcurrentQueue", pairs,
+                  run_queue(queue, pairs));
+    }
+    {
+      queue_storage.reset();
+      using Allocator = AtomicStackAllocator<long long, QUEUE_BYTES>;
+      ConcurrentQueue<long long, Allocator> queue{Allocator(queue_storage)};
+      std::printf("%-32s %8zu %14.2f\n", "ConcurrentQueue+AtomicStack", pairs,
+                  run_queue(queue, pairs));
+    }
+  }
+}
+
+//  Промахи кэша последнего уровня через perf_event_open; если счётчик
+//  недоступен (не Linux, нет прав, виртуальная машина), в отчёте будет "-"
+class CacheMissCounter {
+ public:
+  CacheMissCounter();
+  ~CacheMissCounter();
+  CacheMissCounter(const CacheMissCounter& other) = delete;
+  CacheMissCounter& operator=(const CacheMissCounter& other) = delete;
+  bool available() const;
+  void start();
+  long long stop();
+
+ private:
+  int fd_ = -1;
+};
+
+CacheMissCounter::CacheMissCounter() {
+#ifdef __linux__
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+}
+
+CacheMissCounter::~CacheMissCounter() {
+#ifdef __linux__
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+#endif
+}
+
+bool CacheMissCounter::available() const {
+  return fd_ >= 0;
+}
+
+void CacheMissCounter::start() {
+#ifdef __linux__
+  if (fd_ >= 0) {
+    ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+}
+
+long long CacheMissCounter::stop() {
+  long long misses = 0;
+#ifdef __linux__
+  if (fd_ >= 0) {
+    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd_, &misses, sizeof(misses)) != sizeof(misses)) {
+      misses = 0;
+    }
+  }
+#endif
+  return misses;
+}
+
+template <size_t Size>
+struct Payload {
+  long long key;
+  char padding[Size - sizeof(long long)];
+  Payload(long long key = 0) : key(key) {
+  }
+};
+
+//  Без дополнения: массив нулевой длины в ISO C++ запрещён
+template <>
+struct Payload<sizeof(long long)> {
+  long long key;
+  Payload(long long key = 0) : key(key) {
+  }
+};
+
+template <typename Container>
+void erase_every_other(Container& container) {
+  if constexpr (std::random_access_iterator<typename Container::iterator>) {
+    size_t index = 0;
+    container.erase(std::remove_if(container.begin(), container.end(),
+                                   [&index](const auto&) { return index++ % 2 == 0; }),
+                    container.end());
+  } else {
+    auto iter = container.begin();
+    while (iter != container.end()) {
+      auto next = std::next(iter);
+      container.erase(iter);
+      if (next == container.end()) {
+        break;
+      }
+      iter = std::next(next);
+    }
+  }
+}
+
+//  Для узловых контейнеров середина находится заранее (в prepare), в замер
+//  попадают только сами вставки
+template <typename Container>
+void insert_middle(Container& container, typename Container::iterator middle,
+                   size_t inserts) {
+  for (size_t i = 0; i < inserts; ++i) {
+    if constexpr (std::random_access_iterator<typename Container::iterator>) {
+      middle = container.begin() + container.size() / 2;
+    }
+    container.insert(middle, static_cast<long long>(i));
+  }
+}
+
+//  make() строит пустой контейнер, cleanup() вызывается после его разрушения
+//  (для StackAllocator - reset хранилища); op возвращает число операций
+template <typename Container>
+void measure_op(const char* name, const char* op_name, size_t element_size,
+                size_t count, const std::function<Container()>& make,
+                const std::function<void()>& cleanup,
+                const std::function<size_t(Container&)>& prepare,
+                const std::function<size_t(Container&)>& op) {
+  static CacheMissCounter counter;
+  size_t rounds = std::max<size_t>(1, ELEMENT_OPS / count);
+  double seconds = 0;
+  long long misses = 0;
+  size_t ops = 0;
+  for (size_t round = 0; round < rounds; ++round) {
+    {
+      Container container = make();
+      prepare(container);
+      counter.start();
+      Clock::time_point start = Clock::now();
+      ops += op(container);
+      seconds += std::chrono::duration<double>(Clock::now() - start).count();
+      misses += counter.stop();
+    }
+    cleanup();
+  }
+  std::printf("%-22s %6zu %8zu %-14s %10.2f", name, element_size, count,
+              op_name, seconds * 1e9 / ops);
+  if (counter.available()) {
+    std::printf(" %14.3f\n", static_cast<double>(misses) / ops);
+  } else {
+    std::printf(" %14s\n", "-");
+  }
+}
+
+template <typename Container>
+void bench_container(const char* name, size_t element_size, size_t count,
+                     const std::function<Container()>& make,
+                     const std::function<void()>& cleanup) {
+  auto nothing = [](Container&) -> size_t { return 0; };
+  auto fill = [count](Container& container) -> size_t {
+    for (size_t i = 0; i < count; ++i) {
+      container.push_back(static_cast<long long>(i));
+    }
+    return count;
+  };
+  measure_op<Container>(name, "push_back", element_size, count, make, cleanup,
+                        nothing, fill);
+  if constexpr (requires(Container& c) { c.push_front(0LL); }) {
+    measure_op<Container>(name, "push_front", element_size, count, make,
+                          cleanup, nothing, [count](Container& container) {
+                            for (size_t i = 0; i < count; ++i) {
+                              container.push_front(static_cast<long long>(i));
+                            }
+                            return count;
+                          });
+  }
+  size_t inserts = std::min(count, MIDDLE_INSERTS);
+  typename Container::iterator middle;
+  measure_op<Container>(
+      name, "insert_middle", element_size, count, make, cleanup,
+      [&fill, &middle](Container& container) {
+        fill(container);
+        middle = container.begin();
+        std::advance(middle, container.size() / 2);
+        return container.size();
+      },
+      [inserts, &middle](Container& container) {
+        insert_middle(container, middle, inserts);
+        return inserts;
+      });
+  measure_op<Container>(name, "erase_half", element_size, count, make, cleanup,
+                        fill, [count](Container& container) {
+                          erase_every_other(container);
+                          return count / 2;
+                        });
+  measure_op<Container>(name, "iterate", element_size, count, make, cleanup,
+                        fill, [count](Container& container) {
+                          long long sum = 0;
+                          for (const auto& element : container) {
+                            sum += element.key;
+                          }
+                          return count + (sum == 42 ? 1 : 0);
+                        });
+  measure_op<Container>(name, "copy", element_size, count, make, cleanup, fill,
+                        [count](Container& container) {
+                          Container copy(container);
+                          return count + (copy.size() == 42 ? 1 : 0);
+                        });
+}
+
+template <size_t Size>
+void bench_element(size_t count, StackStorage<CONTAINER_BYTES>& storage) {
+  using T = Payload<Size>;
+  using Allocator = StackAllocator<T, CONTAINER_BYTES>;
+  auto nothing = [] {};
+  bench_container<List<T>>("List", Size, count, [] { return List<T>(); },
+                           nothing);
+  bench_container<List<T, Allocator>>(
+      "List+StackAllocator", Size, count,
+      [&storage] { return List<T, Allocator>(Allocator(storage)); },
+      [&storage] { storage.reset(); });
+  bench_container<std::list<T>>("std::list", Size, count,
+                                [] { return std::list<T>(); }, nothing);
+  bench_container<std::deque<T>>("std::deque", Size, count,
+                                  [] { return std::deque<T>(); }, nothing);
+  bench_container<std::vector<T>>("std::vector", Size, count,
+                                  [] { return std::vector<T>(); }, nothing);
+}
+
+//  Операции над List (std::allocator и StackAllocator), std::list, std::deque
+//  и std::vector для разных размеров элементов и длин; ns и промахи кэша на
+//  одну операцию (insert_middle - на одну вставку, erase_half - на удаление)
+void bench_containers() {
+  auto storage = std::make_unique<StackStorage<CONTAINER_BYTES>>();
+  std::printf("%-22s %6s %8s %-14s %10s %14s\n", "container", "bytes", "count",
+              "op", "ns/op", "misses/op");
+  for (size_t count : {1000, 100000}) {
+    bench_element<8>(count, *storage);
+    bench_element<64>(count, *storage);
+  }
+}
+
+//  Упорядоченный индекс: вставка случайных ключей, поиск каждого в другом
+//  порядке, удаление всех; нс на операцию по фазам
+template <typename Set>
+void bench_set(const char* name, Set& set, const std::vector<long long>& keys,
+               const std::vector<long long>& lookups) {
+  Clock::time_point start = Clock::now();
+  for (long long key : keys) {
+    set.insert(key);
+  }
+  Clock::time_point inserted = Clock::now();
+  size_t found = 0;
+  for (long long key : lookups) {
+    found += (set.find(key) != set.end()) ? 1 : 0;
+  }
+  Clock::time_point searched = Clock::now();
+  for (long long key : keys) {
+    set.erase(key);
+  }
+  Clock::time_point erased = Clock::now();
+  auto per_op = [&keys](Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double>(to - from).count() * 1e9 / keys.size();
+  };
+  std::printf("%-32s %10.1f %10.1f %10.1f%s\n", name, per_op(start, inserted),
+              per_op(inserted, searched), per_op(searched, erased),
+              found == lookups.size() ? "" : " (lookup mismatch)");
+}
+
+void bench_index() {
+  std::mt19937_64 generator(3);
+  std::vector<long long> keys(INDEX_ELEMENTS);
+  for (long long& key : keys) {
+    key = static_cast<long long>(generator() >> 1);
+  }
+  std::vector<long long> lookups = keys;
+  std::shuffle(lookups.begin(), lookups.end(), generator);
+  std::printf("%-32s %10s %10s %10s\n", "container", "insert", "find",
+              "erase");
+  using Allocator = StackAllocator<long long, INDEX_BYTES>;
+  {
+    std::set<long long> set;
+    bench_set("std::set", set, keys, lookups);
+  }
+  {
+    auto storage = std::make_unique<StackStorage<INDEX_BYTES>>();
+    std::set<long long, std::less<long long>, Allocator> set{
+        Allocator(*storage)};
+    bench_set("std::set+StackAllocator", set, keys, lookups);
+  }
+  {
+    SkipList<long long> set;
+    bench_set("SkipList", set, keys, lookups);
+  }
+  {
+    auto storage = std::make_unique<StackStorage<INDEX_BYTES>>();
+    SkipList<long long, std::less<long long>, Allocator> set{
+        Allocator(*storage)};
+    bench_set("SkipList+StackAllocator", set, keys, lookups);
+  }
+}
+
+//  Масштабирование по потокам: transform_reduce по готовому SkipIndex
+//  (построение индекса замеряется отдельно) и parallel_sort; список каждый раз
+//  строится заново в свежем StackStorage, чтобы раскладка узлов в памяти была
+//  одинаковой; мс на операцию
+void bench_parallel() {
+  std::mt19937 generator(5);
+  std::vector<long long> values(PARALLEL_ELEMENTS);
+  for (long long& value : values) {
+    value = generator();
+  }
+  std::printf("%-8s %12s %12s %12s\n", "threads", "index ms", "reduce ms",
+              "sort ms");
+  using Allocator = StackAllocator<long long, PARALLEL_BYTES>;
+  size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    auto storage = std::make_unique<StackStorage<PARALLEL_BYTES>>();
+    List<long long, Allocator> list(values.begin(), values.end(),
+                                    Allocator(*storage));
+    Clock::time_point start = Clock::now();
+    SkipIndex index(list, threads);
+    Clock::time_point built = Clock::now();
+    long long sum = parallel_transform_reduce(
+        index, 0LL, std::plus<>(), [](long long value) { return value % 1000; });
+    Clock::time_point reduced = Clock::now();
+    parallel_sort(list, threads);
+    Clock::time_point sorted = Clock::now();
+    auto ms = [](Clock::time_point from, Clock::time_point to) {
+      return std::chrono::duration<double>(to - from).count() * 1e3;
+    };
+    std::printf("%-8zu %12.2f %12.2f %12.2f (checksum %lld)\n", threads,
+                ms(start, built), ms(built, reduced), ms(reduced, sorted), sum);
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string section = argc > 1 ? argv[1] : "";
+  if (section.empty() || section == "allocators") {
+    bench_allocators();
+  }
+  if (section.empty() || section == "traversal") {
+    bench_traversal();
+  }
+  if (section.empty() || section == "queue") {
+    bench_queue();
+  }
+  if (section.empty() || section == "containers") {
+    bench_containers();
+  }
+  if (section.empty() || section == "index") {
+    bench_index();
+  }
+  if (section.empty() || section == "parallel") {
+    bench_parallel();
+  }
+  return 0;
+}
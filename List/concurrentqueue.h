@@ -0,0 +1,321 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+//  Очередь Майкла-Скотта для многих производителей и потребителей без
+//  блокировок. Узлы освобождаются через hazard pointers: извлечённый узел
+//  откладывается и переиспользуется только когда ни один поток его не держит.
+//  Переиспользованные узлы лежат в общем стеке free_ и возвращаются в
+//  аллокатор лишь в деструкторе, поэтому подходит и AtomicStackAllocator
+//  (его deallocate ничего не делает). Аллокатор должен быть потокобезопасным;
+//  одновременно очередью могут пользоваться до MAX_THREADS потоков
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentQueue {
+ public:
+  static const size_t MAX_THREADS = 64;
+
+ private:
+  static const size_t HAZARDS_PER_THREAD = 2;
+  static const size_t RETIRE_THRESHOLD = 2 * MAX_THREADS * HAZARDS_PER_THREAD;
+  struct Node {
+    std::atomic<Node*> next = nullptr;
+    std::atomic<Node*> free_next = nullptr;
+    alignas(T) unsigned char storage[sizeof(T)];
+    T* value();
+  };
+  //  Слот с hazard pointers занимается на время одной операции; отложенные
+  //  узлы слота видит только его текущий владелец
+  struct alignas(64) Slot {
+    std::atomic<bool> busy = false;
+    std::atomic<Node*> hazards[HAZARDS_PER_THREAD] = {};
+    Node* retired = nullptr;
+    size_t retired_count = 0;
+  };
+  class SlotGuard {
+   public:
+    SlotGuard(ConcurrentQueue& queue);
+    ~SlotGuard();
+    Slot& slot;
+  };
+  using NodeAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using AllocatorTraits = std::allocator_traits<NodeAllocator>;
+  [[no_unique_address]] NodeAllocator allocator_;
+  alignas(64) std::atomic<Node*> head_;
+  alignas(64) std::atomic<Node*> tail_;
+  alignas(64) std::atomic<Node*> free_ = nullptr;
+  Slot slots_[MAX_THREADS];
+  Slot& acquire_slot();
+  static Node* protect(const std::atomic<Node*>& source,
+                       std::atomic<Node*>& hazard);
+  static void clear_hazards(Slot& slot);
+  Node* new_node(Slot& slot);
+  void push_free(Node* node);
+  void retire(Slot& slot, Node* node);
+  void scan(Slot& slot);
+  void destroy_nodes(Node* node, std::atomic<Node*> Node::*link);
+
+ public:
+  ConcurrentQueue();
+  ConcurrentQueue(const Allocator& allocator);
+  ConcurrentQueue(const ConcurrentQueue& other) = delete;
+  ConcurrentQueue& operator=(const ConcurrentQueue& other) = delete;
+  ~ConcurrentQueue();
+  void push(const T& element);
+  void push(T&& element);
+  template <typename... Args>
+  void emplace(Args&&... args);
+  bool try_pop(T& result);
+  bool empty() const;
+};
+
+template <typename T, typename Allocator>
+T* ConcurrentQueue<T, Allocator>::Node::value() {
+  return std::launder(reinterpret_cast<T*>(storage));
+}
+
+template <typename T, typename Allocator>
+ConcurrentQueue<T, Allocator>::SlotGuard::SlotGuard(ConcurrentQueue& queue)
+    : slot(queue.acquire_slot()) {
+}
+
+template <typename T, typename Allocator>
+ConcurrentQueue<T, Allocator>::SlotGuard::~SlotGuard() {
+  clear_hazards(slot);
+  slot.busy.store(false, std::memory_order_release);
+}
+
+//  Поиск начинается с места, зависящего от потока, так что обычно поток
+//  сразу получает «свой» слот
+template <typename T, typename Allocator>
+typename ConcurrentQueue<T, Allocator>::Slot&
+ConcurrentQueue<T, Allocator>::acquire_slot() {
+  static thread_local size_t hint =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) % MAX_THREADS;
+  while (true) {
+    for (size_t i = 0; i < MAX_THREADS; ++i) {
+      size_t index = (hint + i) % MAX_THREADS;
+      Slot& slot = slots_[index];
+      if (!slot.busy.load(std::memory_order_relaxed) &&
+          !slot.busy.exchange(true, std::memory_order_acquire)) {
+        hint = index;
+        return slot;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+
+//  Публикует указатель и перечитывает источник: если он не изменился, узел
+//  был достижим уже после публикации и scan его не освободит
+template <typename T, typename Allocator>
+typename ConcurrentQueue<T, Allocator>::Node*
+ConcurrentQueue<T, Allocator>::protect(const std::atomic<Node*>& source,
+                                       std::atomic<Node*>& hazard) {
+  Node* pointer = source.load();
+  while (true) {
+    hazard.store(pointer);
+    Node* again = source.load();
+    if (again == pointer) {
+      return pointer;
+    }
+    pointer = again;
+  }
+}
+
+template <typename T, typename Allocator>
+void ConcurrentQueue<T, Allocator>::clear_hazards(Slot& slot) {
+  for (std::atomic<Node*>& hazard : slot.hazards) {
+    hazard.store(nullptr, std::memory_order_release);
+  }
+}
+
+//  Стек free_ без ABA: узел попадает в него только через scan, а scan не
+//  вернёт узел, пока на него указывает hazard pointer снимающего потока
+template <typename T, typename Allocator>
+typename ConcurrentQueue<T, Allocator>::Node*
+ConcurrentQueue<T, Allocator>::new_node(Slot& slot) {
+  while (true) {
+    Node* top = protect(free_, slot.hazards[0]);
+    if (top == nullptr) {
+      break;
+    }
+    Node* next = top->free_next.load(std::memory_order_relaxed);
+    if (free_.compare_exchange_weak(top, next, std::memory_order_acquire,
+                                    std::memory_order_relaxed)) {
+      slot.hazards[0].store(nullptr, std::memory_order_release);
+      top->next.store(nullptr, std::memory_order_relaxed);
+      return top;
+    }
+  }
+  slot.hazards[0].store(nullptr, std::memory_order_release);
+  Node* node = AllocatorTraits::allocate(allocator_, 1);
+  ::new (static_cast<void*>(node)) Node;
+  return node;
+}
+
+template <typename T, typename Allocator>
+void ConcurrentQueue<T, Allocator>::push_free(Node* node) {
+  Node* top = free_.load(std::memory_order_relaxed);
+  do {
+    node->free_next.store(top, std::memory_order_relaxed);
+  } while (!free_.compare_exchange_weak(top, node, std::memory_order_release,
+                                        std::memory_order_relaxed));
+}
+
+template <typename T, typename Allocator>
+void ConcurrentQueue<T, Allocator>::retire(Slot& slot, Node* node) {
+  node->free_next.store(slot.retired, std::memory_order_relaxed);
+  slot.retired = node;
+  if (++slot.retired_count >= RETIRE_THRESHOLD) {
+    scan(slot);
+  }
+}
+
+template <typename T, typename Allocator>
+void ConcurrentQueue<T, Allocator>::scan(Slot& slot) {
+  Node* hazards[MAX_THREADS * HAZARDS_PER_THREAD];
+  size_t count = 0;
+  for (Slot& other : slots_) {
+    for (std::atomic<Node*>& hazard : other.hazards) {
+      if (Node* pointer = hazard.load()) {
+        hazards[count++] = pointer;
+      }
+    }
+  }
+  std::sort(hazards, hazards + count);
+  Node* node = slot.retired;
+  slot.retired = nullptr;
+  slot.retired_count = 0;
+  while (node != nullptr) {
+    Node* next = node->free_next.load(std::memory_order_relaxed);
+    if (std::binary_search(hazards, hazards + count, node)) {
+      node->free_next.store(slot.retired, std::memory_order_relaxed);
+      slot.retired = node;
+      ++slot.retired_count;
+    } else {
+      push_free(node);
+    }
+    node = next;
+  }
+}
+
+template <typename T, typename Allocator>
+void ConcurrentQueue<T, Allocator>::destroy_nodes(
+    Node* node, std::atomic<Node*> Node::*link) {
+  while (node != nullptr) {
+    Node* next = (node->*link).load(std::memory_order_relaxed);
+    node->~Node();
+    AllocatorTraits::deallocate(allocator_, node, 1);
+    node = next;
+  }
+}
+
+template <typename T, typename Allocator>
+ConcurrentQueue<T, Allocator>::ConcurrentQueue()
+    : ConcurrentQueue(Allocator()) {
+}
+
+//  Голова всегда указывает на фиктивный узел без значения
+template <typename T, typename Allocator>
+ConcurrentQueue<T, Allocator>::ConcurrentQueue(const Allocator& allocator)
+    : allocator_(allocator) {
+  Node* dummy = AllocatorTraits::allocate(allocator_, 1);
+  ::new (static_cast<void*>(dummy)) Node;
+  head_.store(dummy, std::memory_order_relaxed);
+  tail_.store(dummy, std::memory_order_relaxed);
+}
+
+template <typename T, typename Allocator>
+ConcurrentQueue<T, Allocator>::~ConcurrentQueue() {
+  Node* head = head_.load(std::memory_order_acquire);
+  for (Node* node = head->next.load(); node != nullptr; node = node->next.load()) {
+    std::destroy_at(node->value());
+  }
+  destroy_nodes(head, &Node::next);
+  for (Slot& slot : slots_) {
+    destroy_nodes(slot.retired, &Node::free_next);
+  }
+  destroy_nodes(free_.load(std::memory_order_acquire), &Node::free_next);
+}
+
+template <typename T, typename Allocator>
+void ConcurrentQueue<T, Allocator>::push(const T& element) {
+  emplace(element);
+}
+
+template <typename T, typename Allocator>
+void ConcurrentQueue<T, Allocator>::push(T&& element) {
+  emplace(std::move(element));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void ConcurrentQueue<T, Allocator>::emplace(Args&&... args) {
+  SlotGuard guard(*this);
+  Slot& slot = guard.slot;
+  Node* node = new_node(slot);
+  try {
+    ::new (static_cast<void*>(node->storage)) T(std::forward<Args>(args)...);
+  } catch (...) {
+    //  Узел мог побывать в free_ и всё ещё защищаться hazard pointer'ом
+    //  другого потока в new_node, поэтому возвращается только через scan
+    retire(slot, node);
+    throw;
+  }
+  while (true) {
+    Node* tail = protect(tail_, slot.hazards[0]);
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_.compare_exchange_weak(tail, next);
+      continue;
+    }
+    if (tail->next.compare_exchange_weak(next, node, std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+      tail_.compare_exchange_strong(tail, node);
+      return;
+    }
+  }
+}
+
+//  Значение забирается из узла next уже после сдвига головы: next становится
+//  новым фиктивным узлом и защищён hazard pointer'ом, пока мы из него читаем
+template <typename T, typename Allocator>
+bool ConcurrentQueue<T, Allocator>::try_pop(T& result) {
+  SlotGuard guard(*this);
+  Slot& slot = guard.slot;
+  while (true) {
+    Node* head = protect(head_, slot.hazards[0]);
+    Node* next = head->next.load(std::memory_order_acquire);
+    slot.hazards[1].store(next);
+    if (head != head_.load()) {
+      continue;
+    }
+    if (next == nullptr) {
+      return false;
+    }
+    Node* tail = tail_.load();
+    if (head == tail) {
+      tail_.compare_exchange_weak(tail, next);
+      continue;
+    }
+    if (head_.compare_exchange_strong(head, next)) {
+      result = std::move(*next->value());
+      std::destroy_at(next->value());
+      clear_hazards(slot);
+      retire(slot, head);
+      return true;
+    }
+  }
+}
+
+template <typename T, typename Allocator>
+bool ConcurrentQueue<T, Allocator>::empty() const {
+  return head_.load()->next.load() == nullptr;
+}
@@ -0,0 +1,490 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+//  Интрузивный список: узлом служит поле-хук внутри самого объекта, поэтому
+//  вставка и удаление ничего не выделяют и не копируют. Список не владеет
+//  объектами - erase/pop/clear только отвязывают их.
+//
+//  struct Task {
+//    int id;
+//    ListHook<> hook;
+//  };
+//  IntrusiveList<Task, &Task::hook> queue;
+
+struct ListHookBase {
+  ListHookBase* previous = nullptr;
+  ListHookBase* next = nullptr;
+};
+
+//  AutoUnlink: деструктор объекта сам вынимает его из списка; за это size()
+//  у такого списка считается обходом. Без AutoUnlink объект нужно отвязать
+//  до уничтожения. Копирование объекта не копирует его связи
+template <bool AutoUnlink = false>
+struct ListHook : ListHookBase {
+  static const bool AUTO_UNLINK = AutoUnlink;
+  ListHook() = default;
+  ListHook(const ListHook& other);
+  ListHook& operator=(const ListHook& other);
+  ~ListHook();
+  bool is_linked() const;
+  void unlink();
+};
+
+template <bool AutoUnlink>
+ListHook<AutoUnlink>::ListHook(const ListHook&) {
+}
+
+template <bool AutoUnlink>
+ListHook<AutoUnlink>& ListHook<AutoUnlink>::operator=(const ListHook&) {
+  return *this;
+}
+
+template <bool AutoUnlink>
+ListHook<AutoUnlink>::~ListHook() {
+  if constexpr (AutoUnlink) {
+    unlink();
+  }
+}
+
+template <bool AutoUnlink>
+bool ListHook<AutoUnlink>::is_linked() const {
+  return next != nullptr;
+}
+
+template <bool AutoUnlink>
+void ListHook<AutoUnlink>::unlink() {
+  if (next != nullptr) {
+    previous->next = next;
+    next->previous = previous;
+    previous = nullptr;
+    next = nullptr;
+  }
+}
+
+//  Класс, в котором объявлено поле: для хука из базы T это база
+template <typename MemberPointer>
+struct MemberClass;
+
+template <typename Class, typename Field>
+struct MemberClass<Field Class::*> {
+  using type = Class;
+};
+
+//  Member - указатель на поле-хук в T (&T::hook); итераторы устроены как в
+//  List: один указатель на узел, кольцо замыкается через sentinel_
+template <typename T, auto Member>
+class IntrusiveList {
+ private:
+  using Hook = std::remove_reference_t<decltype(std::declval<T&>().*Member)>;
+  using Owner = typename MemberClass<decltype(Member)>::type;
+  static_assert(std::is_base_of_v<ListHookBase, Hook>,
+                "IntrusiveList member must be a ListHook");
+  static_assert(sizeof(decltype(Member)) == sizeof(ptrdiff_t),
+                "pointer to data member is expected to be a plain offset");
+  static ptrdiff_t hook_offset();
+  size_t size_ = 0;
+  ListHookBase sentinel_ = {&sentinel_, &sentinel_};
+  static T* value_of(ListHookBase* node);
+  static Hook* hook_of(T& value);
+  ListHookBase* sentinel() const;
+  void fix_sentinel(bool is_empty);
+  static void link_before(ListHookBase* place, ListHookBase* node);
+  static void unlink(ListHookBase* node);
+
+ public:
+  template <bool is_const>
+  struct basic_iterator {
+    ListHookBase* node;
+    typedef typename std::conditional<is_const, const T, T>::type value_type;
+    typedef typename std::conditional<is_const, const T&, T&>::type reference;
+    typedef typename std::conditional<is_const, const T*, T*>::type pointer;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    basic_iterator() = default;
+    basic_iterator(ListHookBase* node);
+    basic_iterator& operator++();
+    basic_iterator operator++(int);
+    basic_iterator& operator--();
+    basic_iterator operator--(int);
+    bool operator==(const basic_iterator& other) const;
+    bool operator!=(const basic_iterator& other) const;
+    reference operator*() const;
+    pointer operator->() const;
+    operator basic_iterator<true>() const;
+  };
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  IntrusiveList() = default;
+  IntrusiveList(const IntrusiveList& other) = delete;
+  IntrusiveList(IntrusiveList&& other) noexcept;
+  ~IntrusiveList();
+  IntrusiveList& operator=(const IntrusiveList& other) = delete;
+  IntrusiveList& operator=(IntrusiveList&& other) noexcept;
+  void swap(IntrusiveList& other);
+  size_t size() const;
+  bool empty() const;
+  void push_back(T& value);
+  void pop_back();
+  void push_front(T& value);
+  void pop_front();
+  T& front();
+  T& back();
+  iterator begin();
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  iterator end();
+  const_iterator end() const;
+  const_iterator cend() const;
+  reverse_iterator rbegin();
+  const_reverse_iterator rbegin() const;
+  const_reverse_iterator crbegin() const;
+  reverse_iterator rend();
+  const_reverse_iterator rend() const;
+  const_reverse_iterator crend() const;
+  iterator iterator_to(T& value);
+  iterator insert(const const_iterator& iter, T& value);
+  iterator erase(const const_iterator& iter);
+  void clear();
+  void splice(const const_iterator& pos, IntrusiveList& other);
+};
+
+//  Смещение поля в Owner. В Itanium C++ ABI (GCC, Clang) указатель на
+//  поле и есть это смещение, так же его читает boost::intrusive; offsetof
+//  требует имени поля, а не указателя на член
+template <typename T, auto Member>
+ptrdiff_t IntrusiveList<T, Member>::hook_offset() {
+  return std::bit_cast<ptrdiff_t>(Member);
+}
+
+template <typename T, auto Member>
+T* IntrusiveList<T, Member>::value_of(ListHookBase* node) {
+  char* hook = reinterpret_cast<char*>(static_cast<Hook*>(node));
+  return static_cast<T*>(reinterpret_cast<Owner*>(hook - hook_offset()));
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::Hook* IntrusiveList<T, Member>::hook_of(
+    T& value) {
+  return &(value.*Member);
+}
+
+template <typename T, auto Member>
+ListHookBase* IntrusiveList<T, Member>::sentinel() const {
+  return const_cast<ListHookBase*>(&sentinel_);
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::fix_sentinel(bool is_empty) {
+  if (is_empty) {
+    sentinel_.previous = &sentinel_;
+    sentinel_.next = &sentinel_;
+  } else {
+    sentinel_.next->previous = &sentinel_;
+    sentinel_.previous->next = &sentinel_;
+  }
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::link_before(ListHookBase* place,
+                                           ListHookBase* node) {
+  ListHookBase* previous = place->previous;
+  node->previous = previous;
+  node->next = place;
+  previous->next = node;
+  place->previous = node;
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::unlink(ListHookBase* node) {
+  node->previous->next = node->next;
+  node->next->previous = node->previous;
+  node->previous = nullptr;
+  node->next = nullptr;
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+IntrusiveList<T, Member>::basic_iterator<is_const>::basic_iterator(
+    ListHookBase* node)
+    : node(node) {
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+typename IntrusiveList<T, Member>::template basic_iterator<is_const>&
+IntrusiveList<T, Member>::basic_iterator<is_const>::operator++() {
+  node = node->next;
+  return *this;
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+typename IntrusiveList<T, Member>::template basic_iterator<is_const>
+IntrusiveList<T, Member>::basic_iterator<is_const>::operator++(int) {
+  basic_iterator copy = basic_iterator(*this);
+  node = node->next;
+  return copy;
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+typename IntrusiveList<T, Member>::template basic_iterator<is_const>&
+IntrusiveList<T, Member>::basic_iterator<is_const>::operator--() {
+  node = node->previous;
+  return *this;
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+typename IntrusiveList<T, Member>::template basic_iterator<is_const>
+IntrusiveList<T, Member>::basic_iterator<is_const>::operator--(int) {
+  basic_iterator copy = basic_iterator(*this);
+  node = node->previous;
+  return copy;
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+bool IntrusiveList<T, Member>::basic_iterator<is_const>::operator==(
+    const basic_iterator& other) const {
+  return node == other.node;
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+bool IntrusiveList<T, Member>::basic_iterator<is_const>::operator!=(
+    const basic_iterator& other) const {
+  return node != other.node;
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+typename IntrusiveList<T, Member>::template basic_iterator<is_const>::reference
+IntrusiveList<T, Member>::basic_iterator<is_const>::operator*() const {
+  return *value_of(node);
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+typename IntrusiveList<T, Member>::template basic_iterator<is_const>::pointer
+IntrusiveList<T, Member>::basic_iterator<is_const>::operator->() const {
+  return value_of(node);
+}
+
+template <typename T, auto Member>
+template <bool is_const>
+IntrusiveList<T, Member>::basic_iterator<is_const>::operator IntrusiveList<
+    T, Member>::basic_iterator<true>() const {
+  return basic_iterator<true>(node);
+}
+
+template <typename T, auto Member>
+IntrusiveList<T, Member>::IntrusiveList(IntrusiveList&& other) noexcept {
+  swap(other);
+}
+
+//  Оставшиеся объекты отвязываются, чтобы их хуки не ссылались на sentinel_
+template <typename T, auto Member>
+IntrusiveList<T, Member>::~IntrusiveList() {
+  clear();
+}
+
+template <typename T, auto Member>
+IntrusiveList<T, Member>& IntrusiveList<T, Member>::operator=(
+    IntrusiveList&& other) noexcept {
+  if (this != &other) {
+    clear();
+    swap(other);
+  }
+  return *this;
+}
+
+//  Пустоту нужно запомнить до обмена: у AutoUnlink-списка size_ не точен
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::swap(IntrusiveList& other) {
+  bool was_empty = empty();
+  bool other_was_empty = other.empty();
+  std::swap(size_, other.size_);
+  std::swap(sentinel_, other.sentinel_);
+  fix_sentinel(other_was_empty);
+  other.fix_sentinel(was_empty);
+}
+
+template <typename T, auto Member>
+size_t IntrusiveList<T, Member>::size() const {
+  if constexpr (Hook::AUTO_UNLINK) {
+    return static_cast<size_t>(std::distance(cbegin(), cend()));
+  } else {
+    return size_;
+  }
+}
+
+template <typename T, auto Member>
+bool IntrusiveList<T, Member>::empty() const {
+  return sentinel_.next == &sentinel_;
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::push_back(T& value) {
+  insert(end(), value);
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::pop_back() {
+  erase(const_iterator(sentinel_.previous));
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::push_front(T& value) {
+  insert(begin(), value);
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::pop_front() {
+  erase(begin());
+}
+
+template <typename T, auto Member>
+T& IntrusiveList<T, Member>::front() {
+  return *value_of(sentinel_.next);
+}
+
+template <typename T, auto Member>
+T& IntrusiveList<T, Member>::back() {
+  return *value_of(sentinel_.previous);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::iterator IntrusiveList<T, Member>::begin() {
+  return iterator(sentinel_.next);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::const_iterator
+IntrusiveList<T, Member>::begin() const {
+  return const_iterator(sentinel_.next);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::const_iterator
+IntrusiveList<T, Member>::cbegin() const {
+  return const_iterator(sentinel_.next);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::iterator IntrusiveList<T, Member>::end() {
+  return iterator(&sentinel_);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::const_iterator IntrusiveList<T, Member>::end()
+    const {
+  return const_iterator(sentinel());
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::const_iterator
+IntrusiveList<T, Member>::cend() const {
+  return const_iterator(sentinel());
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::reverse_iterator
+IntrusiveList<T, Member>::rbegin() {
+  return reverse_iterator(end());
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::const_reverse_iterator
+IntrusiveList<T, Member>::rbegin() const {
+  return crbegin();
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::const_reverse_iterator
+IntrusiveList<T, Member>::crbegin() const {
+  return const_reverse_iterator(cend());
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::reverse_iterator
+IntrusiveList<T, Member>::rend() {
+  return reverse_iterator(begin());
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::const_reverse_iterator
+IntrusiveList<T, Member>::rend() const {
+  return crend();
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::const_reverse_iterator
+IntrusiveList<T, Member>::crend() const {
+  return const_reverse_iterator(cbegin());
+}
+
+//  Итератор на объект, уже лежащий в этом списке, за O(1)
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::iterator IntrusiveList<T, Member>::iterator_to(
+    T& value) {
+  return iterator(hook_of(value));
+}
+
+//  Объект не должен уже состоять в каком-либо списке
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::iterator IntrusiveList<T, Member>::insert(
+    const const_iterator& iter, T& value) {
+  Hook* node = hook_of(value);
+  link_before(iter.node, node);
+  ++size_;
+  return iterator(node);
+}
+
+template <typename T, auto Member>
+typename IntrusiveList<T, Member>::iterator IntrusiveList<T, Member>::erase(
+    const const_iterator& iter) {
+  ListHookBase* next = iter.node->next;
+  unlink(iter.node);
+  --size_;
+  return iterator(next);
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::clear() {
+  ListHookBase* node = sentinel_.next;
+  while (node != &sentinel_) {
+    ListHookBase* next = node->next;
+    node->previous = nullptr;
+    node->next = nullptr;
+    node = next;
+  }
+  sentinel_.previous = &sentinel_;
+  sentinel_.next = &sentinel_;
+  size_ = 0;
+}
+
+template <typename T, auto Member>
+void IntrusiveList<T, Member>::splice(const const_iterator& pos,
+                                      IntrusiveList& other) {
+  if (&other == this || other.empty()) {
+    return;
+  }
+  ListHookBase* first = other.sentinel_.next;
+  ListHookBase* last = other.sentinel_.previous;
+  other.sentinel_.previous = &other.sentinel_;
+  other.sentinel_.next = &other.sentinel_;
+  ListHookBase* previous = pos.node->previous;
+  first->previous = previous;
+  last->next = pos.node;
+  previous->next = first;
+  pos.node->previous = last;
+  size_ += other.size_;
+  other.size_ = 0;
+}
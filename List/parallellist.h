@@ -0,0 +1,202 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "stackallocator.h"
+
+//  Параллельные алгоритмы над списками. По связному списку нельзя перейти к
+//  середине, не пройдя его, поэтому границы отрезков запоминаются заранее в
+//  SkipIndex: один последовательный проход, после которого каждый отрезок
+//  обходит свой поток. Индекс годен, пока не удалены граничные элементы;
+//  вставки его не портят, а лишь делают отрезки неравными. Параллельная
+//  сортировка, перевязывающая узлы, - parallel_sort(list, threads) в конце
+//  файла
+
+//  Выполняет task(0), ..., task(count - 1) в count потоках (task(0) - в
+//  вызывающем) и ждёт всех; первое исключение пробрасывается после join.
+//  jthread присоединяется в деструкторе, так что и при system_error из
+//  emplace_back уже запущенные потоки дожидаются, а не роняют программу
+template <typename Task>
+void run_parallel(size_t count, Task task) {
+  std::vector<std::exception_ptr> errors(count);
+  std::vector<std::jthread> workers;
+  workers.reserve(count);
+  for (size_t index = 1; index < count; ++index) {
+    workers.emplace_back([&task, &errors, index] {
+      try {
+        task(index);
+      } catch (...) {
+        errors[index] = std::current_exception();
+      }
+    });
+  }
+  if (count > 0) {
+    try {
+      task(0);
+    } catch (...) {
+      errors[0] = std::current_exception();
+    }
+  }
+  for (std::jthread& worker : workers) {
+    worker.join();
+  }
+  for (std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+//  Итераторы на начала segments отрезков примерно равной длины и на конец
+template <typename Iterator>
+class SkipIndex {
+ public:
+  SkipIndex() = default;
+  template <typename Container>
+  SkipIndex(Container& container, size_t segments);
+  size_t segments() const;
+  Iterator segment_begin(size_t segment) const;
+  Iterator segment_end(size_t segment) const;
+
+ private:
+  std::vector<Iterator> bounds_;
+};
+
+template <typename Container>
+SkipIndex(Container& container, size_t segments)
+    -> SkipIndex<decltype(std::declval<Container&>().begin())>;
+
+template <typename Iterator>
+template <typename Container>
+SkipIndex<Iterator>::SkipIndex(Container& container, size_t segments) {
+  size_t size = container.size();
+  if (size == 0) {
+    return;
+  }
+  segments = std::clamp<size_t>(segments, 1, size);
+  size_t stride = (size + segments - 1) / segments;
+  bounds_.reserve(segments + 1);
+  Iterator iter = container.begin();
+  for (size_t position = 0; position < size; ++position, ++iter) {
+    if (position % stride == 0) {
+      bounds_.push_back(iter);
+    }
+  }
+  bounds_.push_back(iter);
+}
+
+template <typename Iterator>
+size_t SkipIndex<Iterator>::segments() const {
+  return bounds_.empty() ? 0 : bounds_.size() - 1;
+}
+
+template <typename Iterator>
+Iterator SkipIndex<Iterator>::segment_begin(size_t segment) const {
+  return bounds_[segment];
+}
+
+template <typename Iterator>
+Iterator SkipIndex<Iterator>::segment_end(size_t segment) const {
+  return bounds_[segment + 1];
+}
+
+//  Каждый отрезок индекса обходит свой поток со своей копией function
+template <typename Iterator, typename Function>
+void parallel_for_each(const SkipIndex<Iterator>& index, Function function) {
+  run_parallel(index.segments(), [&index, &function](size_t segment) {
+    Function local = function;
+    Iterator end = index.segment_end(segment);
+    for (Iterator iter = index.segment_begin(segment); iter != end; ++iter) {
+      local(*iter);
+    }
+  });
+}
+
+//  reduce должна быть ассоциативной: частичные результаты отрезков
+//  сворачиваются с init слева направо, но порядок внутри отрезков свой
+template <typename Iterator, typename U, typename Reduce, typename Transform>
+U parallel_transform_reduce(const SkipIndex<Iterator>& index, U init,
+                            Reduce reduce, Transform transform) {
+  std::vector<std::optional<U>> partials(index.segments());
+  run_parallel(index.segments(), [&index, &partials, &reduce,
+                                  &transform](size_t segment) {
+    Iterator iter = index.segment_begin(segment);
+    Iterator end = index.segment_end(segment);
+    U partial = transform(*iter);
+    for (++iter; iter != end; ++iter) {
+      partial = reduce(std::move(partial), transform(*iter));
+    }
+    partials[segment] = std::move(partial);
+  });
+  for (std::optional<U>& partial : partials) {
+    init = reduce(std::move(init), std::move(*partial));
+  }
+  return init;
+}
+
+//  Список режется на куски подряд (не короче PARALLEL_GRAIN), каждый поток
+//  сортирует слиянием свой кусок со своей копией compare, затем соседние
+//  куски сливаются попарно, тоже параллельно на каждом уровне, так что
+//  сортировка остаётся устойчивой. Узлы только перевязываются: значения не
+//  перемещаются и аллокатор не вызывается. Как и для List::sort, compare не
+//  должен бросать исключений. Цепочки узлов List - закрытые, отсюда друг
+template <typename T, typename Allocator>
+struct ParallelListSort {
+  using ListType = List<T, Allocator>;
+  using BaseNode = typename ListType::BaseNode;
+  static const size_t PARALLEL_GRAIN = 1 << 12;
+  template <typename Compare>
+  static void sort(ListType& list, size_t threads, Compare compare);
+};
+
+template <typename T, typename Allocator, typename Compare>
+void parallel_sort(List<T, Allocator>& list, size_t threads, Compare compare) {
+  ParallelListSort<T, Allocator>::sort(list, threads, compare);
+}
+
+template <typename T, typename Allocator>
+void parallel_sort(List<T, Allocator>& list, size_t threads) {
+  parallel_sort(list, threads, std::less<T>());
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void ParallelListSort<T, Allocator>::sort(ListType& list, size_t threads,
+                                          Compare compare) {
+  size_t parts = std::min(threads, list.size_ / PARALLEL_GRAIN);
+  if (parts < 2) {
+    list.sort(compare);
+    return;
+  }
+  std::vector<BaseNode*> heads(parts);
+  std::vector<size_t> counts(parts);
+  BaseNode* node = list.sentinel_.next;
+  for (size_t part = 0; part < parts; ++part) {
+    heads[part] = node;
+    counts[part] = list.size_ / parts + (part < list.size_ % parts ? 1 : 0);
+    for (size_t i = 0; i < counts[part]; ++i) {
+      node = node->next;
+    }
+  }
+  run_parallel(parts, [&heads, &counts, &compare](size_t part) {
+    Compare local = compare;
+    heads[part] = ListType::sort_chain(heads[part], counts[part], local);
+  });
+  for (size_t step = 1; step < parts; step *= 2) {
+    size_t pairs = (parts + step - 1) / (2 * step);
+    run_parallel(pairs, [&heads, &compare, step](size_t pair) {
+      size_t left = pair * 2 * step;
+      Compare local = compare;
+      heads[left] =
+          ListType::merge_chains(heads[left], heads[left + step], local);
+    });
+  }
+  list.relink_chain(heads[0]);
+}
@@ -0,0 +1,624 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "stackallocator.h"
+
+//  Упорядоченное множество на списке с пропусками: поиск, вставка и удаление
+//  за O(log n) в среднем. Узел вместе с башней указателей переменной высоты
+//  выделяется одним вызовом аллокатора, так что со StackAllocator весь индекс
+//  лежит в одном StackStorage. Уровень 0 - двусвязное кольцо через sentinel_,
+//  как в List; верхние уровни односвязные и тоже заканчиваются в sentinel_.
+//  Элементы неизменяемы, итераторы остаются валидными до удаления их элемента
+template <typename T, typename Compare = std::less<T>,
+          typename Allocator = std::allocator<T>>
+class SkipList {
+ public:
+  static const size_t MAX_LEVEL = 32;
+
+ private:
+  struct BaseNode {
+    BaseNode* previous;
+    BaseNode** next;
+  };
+  struct Node : BaseNode {
+    size_t height;
+    T value;
+  };
+  struct Head : BaseNode {
+    BaseNode* links[MAX_LEVEL];
+  };
+  //  Единица выделения: башня идёт сразу за Node, узел занимает целое число
+  //  блоков с выравниванием Node
+  struct alignas(Node) Block {
+    unsigned char bytes[alignof(Node)];
+  };
+  static const size_t TOWER_OFFSET = (sizeof(Node) + alignof(BaseNode*) - 1) /
+                                     alignof(BaseNode*) * alignof(BaseNode*);
+  using BlockAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+  using AllocatorTraits = std::allocator_traits<BlockAllocator>;
+  [[no_unique_address]] BlockAllocator allocator_;
+  [[no_unique_address]] Compare compare_;
+  size_t size_ = 0;
+  size_t level_ = 1;
+  uint64_t random_ = 0x9E3779B97F4A7C15ull;
+  Head sentinel_;
+  BaseNode* sentinel() const;
+  void reset_sentinel();
+  void fix_sentinel(BaseNode* old);
+  static size_t block_count(size_t height);
+  size_t random_height();
+  template <typename... Args>
+  Node* construct_node(Args&&... args);
+  void destroy_node(BaseNode* node);
+  static const T& value_of(BaseNode* node);
+  BaseNode* find_predecessors(const T& key, BaseNode** update) const;
+  std::pair<BaseNode*, bool> insert_node(Node* node);
+  void fill_copy(const SkipList& other);
+  void swap_nodes(SkipList& other);
+
+ public:
+  //  Элементы множества неизменяемы, поэтому iterator совпадает с
+  //  const_iterator
+  struct const_iterator {
+    BaseNode* node;
+    using value_type = const T;
+    using reference = const T&;
+    using pointer = const T*;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    const_iterator() = default;
+    const_iterator(BaseNode* node);
+    const_iterator& operator++();
+    const_iterator operator++(int);
+    const_iterator& operator--();
+    const_iterator operator--(int);
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+    reference operator*() const;
+    pointer operator->() const;
+  };
+  using iterator = const_iterator;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = const_reverse_iterator;
+  SkipList();
+  SkipList(const Allocator& allocator);
+  SkipList(const Compare& compare, const Allocator& allocator = Allocator());
+  SkipList(std::initializer_list<T> init, const Compare& compare = Compare(),
+           const Allocator& allocator = Allocator());
+  SkipList(const SkipList& other);
+  SkipList(SkipList&& other) noexcept;
+  ~SkipList();
+  SkipList& operator=(const SkipList& other);
+  SkipList& operator=(SkipList&& other);
+  void swap(SkipList& other);
+  Allocator get_allocator() const;
+  size_t size() const;
+  bool empty() const;
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  const_iterator end() const;
+  const_iterator cend() const;
+  const_reverse_iterator rbegin() const;
+  const_reverse_iterator crbegin() const;
+  const_reverse_iterator rend() const;
+  const_reverse_iterator crend() const;
+  std::pair<iterator, bool> insert(const T& element);
+  std::pair<iterator, bool> insert(T&& element);
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  iterator erase(const const_iterator& iter);
+  size_t erase(const T& key);
+  void clear();
+  const_iterator find(const T& key) const;
+  bool contains(const T& key) const;
+  const_iterator lower_bound(const T& key) const;
+  const_iterator upper_bound(const T& key) const;
+};
+
+//  end() указывает на sentinel_ и у константного списка, отсюда const_cast
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::BaseNode*
+SkipList<T, Compare, Allocator>::sentinel() const {
+  return const_cast<Head*>(&sentinel_);
+}
+
+template <typename T, typename Compare, typename Allocator>
+void SkipList<T, Compare, Allocator>::reset_sentinel() {
+  sentinel_.previous = &sentinel_;
+  sentinel_.next = sentinel_.links;
+  std::fill(sentinel_.links, sentinel_.links + MAX_LEVEL, &sentinel_);
+  level_ = 1;
+}
+
+//  После обмена башнями узлы всё ещё ссылаются на чужой sentinel old:
+//  спуск по уровням сверху находит последний узел каждого уровня за O(log n)
+template <typename T, typename Compare, typename Allocator>
+void SkipList<T, Compare, Allocator>::fix_sentinel(BaseNode* old) {
+  sentinel_.next = sentinel_.links;
+  BaseNode* node = &sentinel_;
+  for (size_t level = MAX_LEVEL; level-- > 0;) {
+    while (node->next[level] != old) {
+      node = node->next[level];
+    }
+    node->next[level] = &sentinel_;
+  }
+  if (size_ == 0) {
+    sentinel_.previous = &sentinel_;
+  } else {
+    sentinel_.next[0]->previous = &sentinel_;
+  }
+}
+
+template <typename T, typename Compare, typename Allocator>
+size_t SkipList<T, Compare, Allocator>::block_count(size_t height) {
+  return (TOWER_OFFSET + height * sizeof(BaseNode*) + sizeof(Block) - 1) /
+         sizeof(Block);
+}
+
+//  Высота распределена геометрически с p = 1/2 (xorshift64); p = 1/4 экономит
+//  указатели, но на поиск уходит заметно больше сравнений и промахов
+template <typename T, typename Compare, typename Allocator>
+size_t SkipList<T, Compare, Allocator>::random_height() {
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 7;
+  random_ ^= random_ << 17;
+  uint64_t bits = random_ | (uint64_t(1) << (MAX_LEVEL - 1));
+  return 1 + std::countr_zero(bits);
+}
+
+template <typename T, typename Compare, typename Allocator>
+template <typename... Args>
+typename SkipList<T, Compare, Allocator>::Node*
+SkipList<T, Compare, Allocator>::construct_node(Args&&... args) {
+  size_t height = random_height();
+  Block* blocks = AllocatorTraits::allocate(allocator_, block_count(height));
+  Node* result = reinterpret_cast<Node*>(blocks);
+  try {
+    AllocatorTraits::construct(allocator_, &(result->value),
+                               std::forward<Args>(args)...);
+  } catch (...) {
+    AllocatorTraits::deallocate(allocator_, blocks, block_count(height));
+    throw;
+  }
+  result->height = height;
+  result->next = reinterpret_cast<BaseNode**>(
+      reinterpret_cast<unsigned char*>(result) + TOWER_OFFSET);
+  return result;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void SkipList<T, Compare, Allocator>::destroy_node(BaseNode* node) {
+  Node* full = static_cast<Node*>(node);
+  size_t count = block_count(full->height);
+  AllocatorTraits::destroy(allocator_, &(full->value));
+  AllocatorTraits::deallocate(allocator_, reinterpret_cast<Block*>(full),
+                              count);
+}
+
+template <typename T, typename Compare, typename Allocator>
+const T& SkipList<T, Compare, Allocator>::value_of(BaseNode* node) {
+  return static_cast<Node*>(node)->value;
+}
+
+//  update[level] - последний узел уровня level, меньший key (для уровней
+//  выше level_ это sentinel_); возвращает первый узел, не меньший key
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::BaseNode*
+SkipList<T, Compare, Allocator>::find_predecessors(const T& key,
+                                                   BaseNode** update) const {
+  BaseNode* end = sentinel();
+  BaseNode* node = end;
+  std::fill(update + level_, update + MAX_LEVEL, end);
+  for (size_t level = level_; level-- > 0;) {
+    while (node->next[level] != end &&
+           compare_(value_of(node->next[level]), key)) {
+      node = node->next[level];
+    }
+    update[level] = node;
+  }
+  return node->next[0];
+}
+
+//  Если равный элемент уже есть, node уничтожается и возвращается найденный
+template <typename T, typename Compare, typename Allocator>
+std::pair<typename SkipList<T, Compare, Allocator>::BaseNode*, bool>
+SkipList<T, Compare, Allocator>::insert_node(Node* node) {
+  BaseNode* update[MAX_LEVEL];
+  BaseNode* found = find_predecessors(node->value, update);
+  if (found != &sentinel_ && !compare_(node->value, value_of(found))) {
+    destroy_node(node);
+    return {found, false};
+  }
+  for (size_t level = 0; level < node->height; ++level) {
+    node->next[level] = update[level]->next[level];
+    update[level]->next[level] = node;
+  }
+  node->previous = update[0];
+  node->next[0]->previous = node;
+  level_ = std::max(level_, node->height);
+  ++size_;
+  return {node, true};
+}
+
+//  Элементы other уже упорядочены, поэтому каждый дописывается в конец всех
+//  своих уровней без поиска
+template <typename T, typename Compare, typename Allocator>
+void SkipList<T, Compare, Allocator>::fill_copy(const SkipList& other) {
+  BaseNode* last[MAX_LEVEL];
+  std::fill(last, last + MAX_LEVEL, &sentinel_);
+  for (const T& element : other) {
+    Node* node = construct_node(element);
+    for (size_t level = 0; level < node->height; ++level) {
+      node->next[level] = &sentinel_;
+      last[level]->next[level] = node;
+      last[level] = node;
+    }
+    node->previous = sentinel_.previous;
+    sentinel_.previous = node;
+    level_ = std::max(level_, node->height);
+    ++size_;
+  }
+}
+
+template <typename T, typename Compare, typename Allocator>
+void SkipList<T, Compare, Allocator>::swap_nodes(SkipList& other) {
+  std::swap(size_, other.size_);
+  std::swap(level_, other.level_);
+  std::swap(sentinel_.previous, other.sentinel_.previous);
+  std::swap(sentinel_.links, other.sentinel_.links);
+  fix_sentinel(&other.sentinel_);
+  other.fix_sentinel(&sentinel_);
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>::const_iterator::const_iterator(BaseNode* node)
+    : node(node) {
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator&
+SkipList<T, Compare, Allocator>::const_iterator::operator++() {
+  node = node->next[0];
+  return *this;
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::const_iterator::operator++(int) {
+  const_iterator copy = *this;
+  ++(*this);
+  return copy;
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator&
+SkipList<T, Compare, Allocator>::const_iterator::operator--() {
+  node = node->previous;
+  return *this;
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::const_iterator::operator--(int) {
+  const_iterator copy = *this;
+  --(*this);
+  return copy;
+}
+
+template <typename T, typename Compare, typename Allocator>
+bool SkipList<T, Compare, Allocator>::const_iterator::operator==(
+    const const_iterator& other) const {
+  return node == other.node;
+}
+
+template <typename T, typename Compare, typename Allocator>
+bool SkipList<T, Compare, Allocator>::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return node != other.node;
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator::reference
+SkipList<T, Compare, Allocator>::const_iterator::operator*() const {
+  return value_of(node);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator::pointer
+SkipList<T, Compare, Allocator>::const_iterator::operator->() const {
+  return &value_of(node);
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>::SkipList()
+    : SkipList(Compare(), Allocator()) {
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>::SkipList(const Allocator& allocator)
+    : SkipList(Compare(), allocator) {
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>::SkipList(const Compare& compare,
+                                          const Allocator& allocator)
+    : allocator_(allocator),
+      compare_(compare) {
+  reset_sentinel();
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>::SkipList(std::initializer_list<T> init,
+                                          const Compare& compare,
+                                          const Allocator& allocator)
+    : SkipList(compare, allocator) {
+  try {
+    for (const T& element : init) {
+      insert(element);
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>::SkipList(const SkipList& other)
+    : allocator_(AllocatorTraits::select_on_container_copy_construction(
+          other.allocator_)),
+      compare_(other.compare_) {
+  reset_sentinel();
+  try {
+    fill_copy(other);
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>::SkipList(SkipList&& other) noexcept
+    : allocator_(std::move(other.allocator_)),
+      compare_(other.compare_) {
+  reset_sentinel();
+  swap_nodes(other);
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>::~SkipList() {
+  clear();
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>& SkipList<T, Compare, Allocator>::operator=(
+    const SkipList& other) {
+  if (this == &other) {
+    return *this;
+  }
+  constexpr bool propagate =
+      AllocatorTraits::propagate_on_container_copy_assignment::value;
+  SkipList temporary(other.compare_,
+                     propagate ? other.get_allocator() : get_allocator());
+  temporary.fill_copy(other);
+  clear();
+  if constexpr (propagate) {
+    allocator_ = other.allocator_;
+  }
+  compare_ = other.compare_;
+  swap_nodes(temporary);
+  return *this;
+}
+
+template <typename T, typename Compare, typename Allocator>
+SkipList<T, Compare, Allocator>& SkipList<T, Compare, Allocator>::operator=(
+    SkipList&& other) {
+  if (this == &other) {
+    return *this;
+  }
+  clear();
+  compare_ = other.compare_;
+  if constexpr (AllocatorTraits::propagate_on_container_move_assignment::
+                    value) {
+    allocator_ = std::move(other.allocator_);
+    swap_nodes(other);
+  } else {
+    if (allocator_ == other.allocator_) {
+      swap_nodes(other);
+    } else {
+      for (BaseNode* node = other.sentinel_.next[0]; node != &other.sentinel_;
+           node = node->next[0]) {
+        insert(std::move(static_cast<Node*>(node)->value));
+      }
+      other.clear();
+    }
+  }
+  return *this;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void SkipList<T, Compare, Allocator>::swap(SkipList& other) {
+  if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+    std::swap(allocator_, other.allocator_);
+  }
+  std::swap(compare_, other.compare_);
+  swap_nodes(other);
+}
+
+template <typename T, typename Compare, typename Allocator>
+Allocator SkipList<T, Compare, Allocator>::get_allocator() const {
+  return Allocator(allocator_);
+}
+
+template <typename T, typename Compare, typename Allocator>
+size_t SkipList<T, Compare, Allocator>::size() const {
+  return size_;
+}
+
+template <typename T, typename Compare, typename Allocator>
+bool SkipList<T, Compare, Allocator>::empty() const {
+  return size_ == 0;
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::begin() const {
+  return const_iterator(sentinel_.next[0]);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::cbegin() const {
+  return begin();
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::end() const {
+  return const_iterator(sentinel());
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::cend() const {
+  return end();
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_reverse_iterator
+SkipList<T, Compare, Allocator>::rbegin() const {
+  return const_reverse_iterator(end());
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_reverse_iterator
+SkipList<T, Compare, Allocator>::crbegin() const {
+  return rbegin();
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_reverse_iterator
+SkipList<T, Compare, Allocator>::rend() const {
+  return const_reverse_iterator(begin());
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_reverse_iterator
+SkipList<T, Compare, Allocator>::crend() const {
+  return rend();
+}
+
+template <typename T, typename Compare, typename Allocator>
+std::pair<typename SkipList<T, Compare, Allocator>::iterator, bool>
+SkipList<T, Compare, Allocator>::insert(const T& element) {
+  return emplace(element);
+}
+
+template <typename T, typename Compare, typename Allocator>
+std::pair<typename SkipList<T, Compare, Allocator>::iterator, bool>
+SkipList<T, Compare, Allocator>::insert(T&& element) {
+  return emplace(std::move(element));
+}
+
+//  Ключ известен только после конструирования, поэтому узел строится до
+//  поиска и уничтожается, если равный элемент уже есть
+template <typename T, typename Compare, typename Allocator>
+template <typename... Args>
+std::pair<typename SkipList<T, Compare, Allocator>::iterator, bool>
+SkipList<T, Compare, Allocator>::emplace(Args&&... args) {
+  auto [node, inserted] =
+      insert_node(construct_node(std::forward<Args>(args)...));
+  return {iterator(node), inserted};
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::iterator
+SkipList<T, Compare, Allocator>::erase(const const_iterator& iter) {
+  BaseNode* update[MAX_LEVEL];
+  BaseNode* node = iter.node;
+  find_predecessors(value_of(node), update);
+  for (size_t level = 0; level < static_cast<Node*>(node)->height; ++level) {
+    update[level]->next[level] = node->next[level];
+  }
+  BaseNode* next = node->next[0];
+  next->previous = node->previous;
+  destroy_node(node);
+  --size_;
+  while (level_ > 1 && sentinel_.next[level_ - 1] == &sentinel_) {
+    --level_;
+  }
+  return iterator(next);
+}
+
+template <typename T, typename Compare, typename Allocator>
+size_t SkipList<T, Compare, Allocator>::erase(const T& key) {
+  const_iterator iter = find(key);
+  if (iter == end()) {
+    return 0;
+  }
+  erase(iter);
+  return 1;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void SkipList<T, Compare, Allocator>::clear() {
+  BaseNode* node = sentinel_.next[0];
+  while (node != &sentinel_) {
+    BaseNode* next = node->next[0];
+    destroy_node(node);
+    node = next;
+  }
+  reset_sentinel();
+  size_ = 0;
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::find(const T& key) const {
+  const_iterator iter = lower_bound(key);
+  if (iter == end() || compare_(key, *iter)) {
+    return end();
+  }
+  return iter;
+}
+
+template <typename T, typename Compare, typename Allocator>
+bool SkipList<T, Compare, Allocator>::contains(const T& key) const {
+  return find(key) != end();
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::lower_bound(const T& key) const {
+  BaseNode* end = sentinel();
+  BaseNode* node = end;
+  for (size_t level = level_; level-- > 0;) {
+    while (node->next[level] != end &&
+           compare_(value_of(node->next[level]), key)) {
+      node = node->next[level];
+    }
+  }
+  return const_iterator(node->next[0]);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename SkipList<T, Compare, Allocator>::const_iterator
+SkipList<T, Compare, Allocator>::upper_bound(const T& key) const {
+  BaseNode* end = sentinel();
+  BaseNode* node = end;
+  for (size_t level = level_; level-- > 0;) {
+    while (node->next[level] != end &&
+           !compare_(key, value_of(node->next[level]))) {
+      node = node->next[level];
+    }
+  }
+  return const_iterator(node->next[0]);
+}
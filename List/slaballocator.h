@@ -0,0 +1,179 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "stackallocator.h"
+
+//  Слябы поверх StackStorage: память берётся у хранилища кусками по
+//  SLAB_BYTES, каждый сляб режется на блоки одного класса размера. Узлы
+//  разных контейнеров (List, std::map, ...) не перемешиваются в общей
+//  вершине стека, а полностью освободившийся сляб переходит к любому классу,
+//  так что смена размеров запросов не фрагментирует арену. Запросы больше
+//  MAX_BYTES или с выравниванием больше CLASS_STEP идут в хранилище напрямую,
+//  поэтому deallocate должен получать то же выравнивание, что и allocate
+template <size_t N>
+class SlabStorage {
+ public:
+  static const size_t SLAB_BYTES = 4096;
+  static const size_t CLASS_STEP = alignof(std::max_align_t);
+  static const size_t CLASS_COUNT = 16;
+  static const size_t MAX_BYTES = CLASS_STEP * CLASS_COUNT;
+  explicit SlabStorage(StackStorage<N>& storage);
+  SlabStorage(const SlabStorage& other) = delete;
+  SlabStorage& operator=(const SlabStorage& other) = delete;
+  void* allocate(size_t bytes, size_t alignment);
+  void deallocate(void* ptr, size_t bytes,
+                  size_t alignment = alignof(std::max_align_t));
+  void reset();
+
+ private:
+  //  Заголовок в начале сляба; слябы выровнены по SLAB_BYTES, поэтому сляб
+  //  блока находится обнулением младших битов адреса
+  struct alignas(std::max_align_t) Slab {
+    Slab* previous;
+    Slab* next;
+    char* free;
+    char* bump;
+    size_t live;
+    size_t block_size;
+    char* end();
+  };
+  StackStorage<N>& storage_;
+  Slab* partial_[CLASS_COUNT] = {};
+  Slab* empty_ = nullptr;
+  static Slab* slab_of(void* ptr);
+  static bool is_full(Slab* slab);
+  static bool is_direct(size_t bytes, size_t alignment);
+  Slab* take_slab(size_t size_class);
+  void link(Slab* slab, size_t size_class);
+  void unlink(Slab* slab, size_t size_class);
+};
+
+//  Узлы, выделенные одним блоком, нельзя вернуть слябам по одному
+template <typename T, size_t N>
+struct is_batch_allocator<StackAllocator<T, N, SlabStorage<N>>>
+    : std::false_type {};
+
+template <typename T, size_t N>
+using SlabAllocator = StackAllocator<T, N, SlabStorage<N>>;
+
+template <size_t N>
+char* SlabStorage<N>::Slab::end() {
+  return reinterpret_cast<char*>(this) + SLAB_BYTES;
+}
+
+template <size_t N>
+SlabStorage<N>::SlabStorage(StackStorage<N>& storage)
+    : storage_(storage) {
+}
+
+template <size_t N>
+typename SlabStorage<N>::Slab* SlabStorage<N>::slab_of(void* ptr) {
+  return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) &
+                                 ~(uintptr_t(SLAB_BYTES) - 1));
+}
+
+template <size_t N>
+bool SlabStorage<N>::is_full(Slab* slab) {
+  return slab->free == nullptr &&
+         static_cast<size_t>(slab->end() - slab->bump) < slab->block_size;
+}
+
+template <size_t N>
+bool SlabStorage<N>::is_direct(size_t bytes, size_t alignment) {
+  return bytes > MAX_BYTES || alignment > CLASS_STEP;
+}
+
+//  size_class - номер класса: блоки по (size_class + 1) * CLASS_STEP байт
+template <size_t N>
+typename SlabStorage<N>::Slab* SlabStorage<N>::take_slab(size_t size_class) {
+  Slab* slab = empty_;
+  if (slab != nullptr) {
+    empty_ = slab->next;
+  } else {
+    slab = static_cast<Slab*>(storage_.allocate(SLAB_BYTES, SLAB_BYTES));
+  }
+  slab->free = nullptr;
+  slab->bump = reinterpret_cast<char*>(slab + 1);
+  slab->live = 0;
+  slab->block_size = (size_class + 1) * CLASS_STEP;
+  link(slab, size_class);
+  return slab;
+}
+
+template <size_t N>
+void SlabStorage<N>::link(Slab* slab, size_t size_class) {
+  slab->previous = nullptr;
+  slab->next = partial_[size_class];
+  if (slab->next != nullptr) {
+    slab->next->previous = slab;
+  }
+  partial_[size_class] = slab;
+}
+
+template <size_t N>
+void SlabStorage<N>::unlink(Slab* slab, size_t size_class) {
+  if (slab->previous != nullptr) {
+    slab->previous->next = slab->next;
+  } else {
+    partial_[size_class] = slab->next;
+  }
+  if (slab->next != nullptr) {
+    slab->next->previous = slab->previous;
+  }
+}
+
+//  В списке partial_ класса лежат только слябы, где есть свободный блок
+template <size_t N>
+void* SlabStorage<N>::allocate(size_t bytes, size_t alignment) {
+  if (is_direct(bytes, alignment)) {
+    return storage_.allocate(bytes, alignment);
+  }
+  size_t size_class = (bytes == 0) ? 0 : (bytes - 1) / CLASS_STEP;
+  Slab* slab = partial_[size_class];
+  if (slab == nullptr) {
+    slab = take_slab(size_class);
+  }
+  char* block = slab->free;
+  if (block != nullptr) {
+    std::memcpy(&slab->free, block, sizeof(char*));
+  } else {
+    block = slab->bump;
+    slab->bump += slab->block_size;
+  }
+  ++slab->live;
+  if (is_full(slab)) {
+    unlink(slab, size_class);
+  }
+  return block;
+}
+
+//  Опустевший сляб уходит в общий список empty_ и достанется любому классу
+template <size_t N>
+void SlabStorage<N>::deallocate(void* ptr, size_t bytes, size_t alignment) {
+  if (is_direct(bytes, alignment)) {
+    storage_.deallocate(ptr, bytes, alignment);
+    return;
+  }
+  Slab* slab = slab_of(ptr);
+  size_t size_class = slab->block_size / CLASS_STEP - 1;
+  if (is_full(slab)) {
+    link(slab, size_class);
+  }
+  char* block = static_cast<char*>(ptr);
+  std::memcpy(block, &slab->free, sizeof(char*));
+  slab->free = block;
+  if (--slab->live == 0) {
+    unlink(slab, size_class);
+    slab->next = empty_;
+    empty_ = slab;
+  }
+}
+
+//  Забывает все слябы; память самого StackStorage освобождает его владелец
+template <size_t N>
+void SlabStorage<N>::reset() {
+  std::fill(partial_, partial_ + CLASS_COUNT, nullptr);
+  empty_ = nullptr;
+}
@@ -1,20 +1,390 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+//  Статистика StackStorage включается при компиляции: -DSTACKSTORAGE_STATS=1.
+//  Без флага StackStats<false> пуст, все его методы ничего не делают, и
+//  хранилище не меняется ни по размеру, ни по коду
+#ifndef STACKSTORAGE_STATS
+#define STACKSTORAGE_STATS 0
+#endif
+
+template <bool Enabled>
+struct StackStats {
+  static const bool ENABLED = false;
+  void record_allocation(size_t) {
+  }
+  void record_free_list_hit() {
+  }
+  void record_padding(size_t) {
+  }
+  void record_usage(size_t) {
+  }
+  void record_overflow() {
+  }
+  void record_deallocation() {
+  }
+  void report(std::ostream& out, size_t capacity) const;
+};
+
+//  histogram[k] - число запросов размером от 2^k до 2^(k+1) - 1 байт;
+//  overflows - выделения, не поместившиеся во встроенный буфер N
+template <>
+struct StackStats<true> {
+  static const bool ENABLED = true;
+  static const size_t BUCKETS = 24;
+  size_t allocations = 0;
+  size_t deallocations = 0;
+  size_t bytes_requested = 0;
+  size_t free_list_hits = 0;
+  size_t padding = 0;
+  size_t high_water = 0;
+  size_t overflows = 0;
+  size_t histogram[BUCKETS] = {};
+  void record_allocation(size_t bytes);
+  void record_free_list_hit();
+  void record_padding(size_t bytes);
+  void record_usage(size_t bytes);
+  void record_overflow();
+  void record_deallocation();
+  void report(std::ostream& out, size_t capacity) const;
+};
+
+template <bool Enabled>
+void StackStats<Enabled>::report(std::ostream& out, size_t) const {
+  out << "StackStorage stats are disabled, rebuild with -DSTACKSTORAGE_STATS=1\n";
+}
+
+inline void StackStats<true>::record_allocation(size_t bytes) {
+  ++allocations;
+  bytes_requested += bytes;
+  size_t bucket = 0;
+  while (bucket + 1 < BUCKETS && (bytes >> (bucket + 1)) != 0) {
+    ++bucket;
+  }
+  ++histogram[bucket];
+}
+
+inline void StackStats<true>::record_free_list_hit() {
+  ++free_list_hits;
+}
+
+inline void StackStats<true>::record_padding(size_t bytes) {
+  padding += bytes;
+}
+
+inline void StackStats<true>::record_usage(size_t bytes) {
+  high_water = std::max(high_water, bytes);
+}
+
+inline void StackStats<true>::record_overflow() {
+  ++overflows;
+}
+
+inline void StackStats<true>::record_deallocation() {
+  ++deallocations;
+}
+
+inline void StackStats<true>::report(std::ostream& out, size_t capacity) const {
+  out << "capacity:        " << capacity << " bytes\n"
+      << "high water mark: " << high_water << " bytes\n"
+      << "allocations:     " << allocations << " (" << bytes_requested
+      << " bytes, " << free_list_hits << " from free lists)\n"
+      << "deallocations:   " << deallocations << "\n"
+      << "padding:         " << padding << " bytes\n"
+      << "overflows:       " << overflows << "\n"
+      << "size histogram:\n";
+  for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+    if (histogram[bucket] != 0) {
+      out << "  [" << (size_t(1) << bucket) << ", "
+          << (size_t(1) << (bucket + 1)) << "): " << histogram[bucket] << "\n";
+    }
+  }
+}
 
 template <size_t N>
 struct StackStorage {
-  char data[N];
+  static const size_t CLASS_STEP = sizeof(void*);
+  static const size_t CLASS_COUNT = 32;
+  //  FIXED: при переполнении буфера bad_alloc; GROWING: продолжаем в цепочке
+  //  кусков из кучи, каждый следующий вдвое больше предыдущего
+  enum class Mode {
+    FIXED,
+    GROWING
+  };
+  struct alignas(std::max_align_t) Chunk {
+    Chunk* previous;
+    size_t size;
+    size_t shift;
+    char* data();
+  };
+  //  Запоминает вершину стека и откатывает к ней при выходе из области видимости:
+  //  всё выделенное после создания маркера освобождается разом, списки
+  //  свободных блоков сбрасываются
+  class Marker {
+   private:
+    StackStorage& storage_;
+    size_t shift_;
+    Chunk* chunk_;
+    size_t chunk_shift_;
+
+   public:
+    explicit Marker(StackStorage& storage);
+    ~Marker();
+    Marker(const Marker& other) = delete;
+    Marker& operator=(const Marker& other) = delete;
+    void rewind();
+  };
+  alignas(std::max_align_t) char data[N];
   size_t shift = 0;
+  char* free_lists[CLASS_COUNT] = {};
+  Mode mode = Mode::FIXED;
+  Chunk* chunks = nullptr;
+  [[no_unique_address]] StackStats<STACKSTORAGE_STATS> stats;
   StackStorage() = default;
-  ~StackStorage() = default;
+  explicit StackStorage(Mode mode);
+  ~StackStorage();
   StackStorage(const StackStorage& other) = delete;
   StackStorage& operator=(const StackStorage& other) = delete;
+  void* allocate(size_t bytes, size_t alignment);
+  void deallocate(void* ptr, size_t bytes,
+                  size_t alignment = alignof(std::max_align_t));
+  void reset();
+  void report(std::ostream& out) const;
+
+ private:
+  void rewind(size_t shift, Chunk* chunk, size_t chunk_shift);
+  size_t bytes_in_use() const;
+  void record_bump(size_t padding);
+  static char* bump(char* base, size_t& shift, size_t capacity, size_t bytes,
+                    size_t alignment);
+  void add_chunk(size_t min_size);
 };
 
-template <typename T, size_t N>
+template <size_t N>
+char* StackStorage<N>::Chunk::data() {
+  return reinterpret_cast<char*>(this + 1);
+}
+
+template <size_t N>
+StackStorage<N>::Marker::Marker(StackStorage& storage)
+    : storage_(storage),
+      shift_(storage.shift),
+      chunk_(storage.chunks),
+      chunk_shift_(storage.chunks == nullptr ? 0 : storage.chunks->shift) {
+}
+
+template <size_t N>
+StackStorage<N>::Marker::~Marker() {
+  rewind();
+}
+
+template <size_t N>
+void StackStorage<N>::Marker::rewind() {
+  storage_.rewind(shift_, chunk_, chunk_shift_);
+}
+
+template <size_t N>
+StackStorage<N>::StackStorage(Mode mode)
+    : mode(mode) {
+}
+
+template <size_t N>
+StackStorage<N>::~StackStorage() {
+  reset();
+}
+
+template <size_t N>
+void StackStorage<N>::rewind(size_t saved_shift, Chunk* chunk,
+                             size_t chunk_shift) {
+  while (chunks != chunk) {
+    Chunk* previous = chunks->previous;
+    ::operator delete(chunks);
+    chunks = previous;
+  }
+  if (chunks != nullptr) {
+    chunks->shift = chunk_shift;
+  }
+  shift = saved_shift;
+  std::fill(free_lists, free_lists + CLASS_COUNT, nullptr);
+}
+
+template <size_t N>
+void StackStorage<N>::reset() {
+  rewind(0, nullptr, 0);
+}
+
+//  Отчёт для подбора N: если были overflows, N стоит поднять хотя бы до
+//  high water mark (он учитывает и память в кусках из кучи)
+template <size_t N>
+void StackStorage<N>::report(std::ostream& out) const {
+  stats.report(out, N);
+}
+
+template <size_t N>
+void StackStorage<N>::record_bump(size_t padding) {
+  stats.record_padding(padding);
+  if constexpr (decltype(stats)::ENABLED) {
+    stats.record_usage(bytes_in_use());
+  }
+}
+
+template <size_t N>
+size_t StackStorage<N>::bytes_in_use() const {
+  size_t total = shift;
+  for (Chunk* chunk = chunks; chunk != nullptr; chunk = chunk->previous) {
+    total += chunk->shift;
+  }
+  return total;
+}
+
+//  Отступ ровно до ближайшего адреса, кратного alignment (alignof типа), так что
+//  подряд идущие объекты с совместимым выравниванием лежат без пропусков;
+//  выравнивание больше max_align_t тоже поддерживается за счёт отступа
+template <size_t N>
+char* StackStorage<N>::bump(char* base, size_t& shift, size_t capacity,
+                            size_t bytes, size_t alignment) {
+  void* ptr = base + shift;
+  size_t space = capacity - shift;
+  if (std::align(alignment, bytes, ptr, space) == nullptr) {
+    return nullptr;
+  }
+  shift = static_cast<char*>(ptr) - base + bytes;
+  return static_cast<char*>(ptr);
+}
+
+template <size_t N>
+void StackStorage<N>::add_chunk(size_t min_size) {
+  size_t size = std::max(chunks == nullptr ? N : 2 * chunks->size, min_size);
+  void* raw = ::operator new(sizeof(Chunk) + size);
+  chunks = new (raw) Chunk{chunks, size, 0};
+}
+
+//  Освобождённые блоки лежат в односвязных списках по классам размера: блок
+//  класса k вмещает не меньше k * CLASS_STEP байт, указатель на следующий
+//  хранится в начале самого блока
+template <size_t N>
+void* StackStorage<N>::allocate(size_t bytes, size_t alignment) {
+  stats.record_allocation(bytes);
+  size_t size_class = (bytes + CLASS_STEP - 1) / CLASS_STEP;
+  if (size_class < CLASS_COUNT && free_lists[size_class] != nullptr &&
+      reinterpret_cast<uintptr_t>(free_lists[size_class]) % alignment == 0) {
+    char* block = free_lists[size_class];
+    std::memcpy(&free_lists[size_class], block, sizeof(char*));
+    stats.record_free_list_hit();
+    return block;
+  }
+  size_t previous_shift = shift;
+  if (char* block = bump(data, shift, N, bytes, alignment)) {
+    record_bump(shift - previous_shift - bytes);
+    return block;
+  }
+  stats.record_overflow();
+  if (mode == Mode::FIXED) {
+    throw std::bad_alloc();
+  }
+  if (chunks != nullptr) {
+    previous_shift = chunks->shift;
+    if (char* block = bump(chunks->data(), chunks->shift, chunks->size, bytes,
+                           alignment)) {
+      record_bump(chunks->shift - previous_shift - bytes);
+      return block;
+    }
+  }
+  add_chunk(bytes + alignment);
+  char* block = bump(chunks->data(), chunks->shift, chunks->size, bytes,
+                     alignment);
+  record_bump(chunks->shift - bytes);
+  return block;
+}
+
+template <size_t N>
+void StackStorage<N>::deallocate(void* ptr, size_t bytes, size_t) {
+  stats.record_deallocation();
+  char* block = static_cast<char*>(ptr);
+  if (block + bytes == data + shift) {
+    shift -= bytes;
+    return;
+  }
+  if (chunks != nullptr && block + bytes == chunks->data() + chunks->shift) {
+    chunks->shift -= bytes;
+    return;
+  }
+  size_t size_class = bytes / CLASS_STEP;
+  if (size_class == 0 || size_class >= CLASS_COUNT) {
+    return;
+  }
+  std::memcpy(block, &free_lists[size_class], sizeof(char*));
+  free_lists[size_class] = block;
+}
+
+//  Общая для нескольких потоков арена: вершина сдвигается CAS-ом без блокировок
+//  (с точным выравниванием, в отличие от fetch_add с запасом), отдельные блоки
+//  не освобождаются, вся память возвращается через reset()
+template <size_t N>
+struct AtomicStackStorage {
+  alignas(std::max_align_t) char data[N];
+  std::atomic<size_t> shift{0};
+  AtomicStackStorage() = default;
+  ~AtomicStackStorage() = default;
+  AtomicStackStorage(const AtomicStackStorage& other) = delete;
+  AtomicStackStorage& operator=(const AtomicStackStorage& other) = delete;
+  void* allocate(size_t bytes, size_t alignment);
+  void deallocate(void* ptr, size_t bytes,
+                  size_t alignment = alignof(std::max_align_t));
+  void reset();
+};
+
+template <size_t N>
+void* AtomicStackStorage<N>::allocate(size_t bytes, size_t alignment) {
+  uintptr_t base = reinterpret_cast<uintptr_t>(data);
+  size_t current = shift.load(std::memory_order_relaxed);
+  while (true) {
+    size_t start = (base + current + alignment - 1) / alignment * alignment - base;
+    if (start + bytes > N) {
+      throw std::bad_alloc();
+    }
+    if (shift.compare_exchange_weak(current, start + bytes,
+                                    std::memory_order_relaxed)) {
+      return data + start;
+    }
+  }
+}
+
+template <size_t N>
+void AtomicStackStorage<N>::deallocate(void*, size_t, size_t) {
+}
+
+template <size_t N>
+void AtomicStackStorage<N>::reset() {
+  shift.store(0, std::memory_order_relaxed);
+}
+
+//  Своя растущая StackStorage<N> у каждого потока, создаётся при первом обращении;
+//  аллокатор на ней нужно создавать в том же потоке, где он используется
+template <size_t N>
+StackStorage<N>& thread_local_storage() {
+  thread_local std::unique_ptr<StackStorage<N>> storage =
+      std::make_unique<StackStorage<N>>(StackStorage<N>::Mode::GROWING);
+  return *storage;
+}
+
+template <typename T, size_t N, typename Storage = StackStorage<N>>
 struct StackAllocator {
-  StackStorage<N>& stack;
+  Storage* stack;
   using pointer = T*;
   using const_pointer = const T*;
   using void_pointer = void*;
@@ -25,106 +395,125 @@ struct StackAllocator {
   ~StackAllocator() = default;
   StackAllocator() = delete;
   StackAllocator(const StackAllocator& other);
-  StackAllocator(StackStorage<N>& stack);
+  StackAllocator(Storage& stack);
   template <typename U>
-  StackAllocator(const StackAllocator<U, N>& other);
-  StackAllocator<T, N>& operator=(const StackAllocator& other);
+  StackAllocator(const StackAllocator<U, N, Storage>& other);
+  StackAllocator<T, N, Storage>& operator=(const StackAllocator& other);
   bool operator==(const StackAllocator& other) const;
   T* allocate(size_t n);
-  void deallocate(const T*, size_t){};
+  void deallocate(T* ptr, size_t n);
   template <typename U>
   struct rebind {
-    using other = StackAllocator<U, N>;
+    using other = StackAllocator<U, N, Storage>;
   };
 };
 
 template <typename T, size_t N>
-StackAllocator<T, N>::StackAllocator(const StackAllocator& other)
+using AtomicStackAllocator = StackAllocator<T, N, AtomicStackStorage<N>>;
+
+template <typename T, size_t N, typename Storage>
+StackAllocator<T, N, Storage>::StackAllocator(const StackAllocator& other)
     : stack(other.stack) {
 }
 
-template <typename T, size_t N>
-StackAllocator<T, N>::StackAllocator(StackStorage<N>& stack)
-    : stack(stack) {
+template <typename T, size_t N, typename Storage>
+StackAllocator<T, N, Storage>::StackAllocator(Storage& stack)
+    : stack(&stack) {
 }
 
-template <typename T, size_t N>
+template <typename T, size_t N, typename Storage>
 template <typename U>
-StackAllocator<T, N>::StackAllocator(const StackAllocator<U, N>& other)
+StackAllocator<T, N, Storage>::StackAllocator(
+    const StackAllocator<U, N, Storage>& other)
     : stack(other.stack) {
 }
 
-template <typename T, size_t N>
-StackAllocator<T, N>& StackAllocator<T, N>::operator=(
+template <typename T, size_t N, typename Storage>
+StackAllocator<T, N, Storage>& StackAllocator<T, N, Storage>::operator=(
     const StackAllocator& other) {
   stack = other.stack;
   return *this;
 }
 
-template <typename T, size_t N>
-bool StackAllocator<T, N>::operator==(const StackAllocator& other) const {
+template <typename T, size_t N, typename Storage>
+bool StackAllocator<T, N, Storage>::operator==(
+    const StackAllocator& other) const {
   return stack == other.stack;
 }
 
-template <typename T, size_t N>
-T* StackAllocator<T, N>::allocate(size_t n) {
-  size_t offset =
-      (sizeof(T) - (size_t(stack.data) + stack.shift) % sizeof(T)) % sizeof(T);
-  if (stack.shift + n * sizeof(T) + offset > N) {
-    throw std::bad_alloc();
-  }
-  stack.shift += n * sizeof(T) + offset;
-  return reinterpret_cast<T*>(stack.data + (stack.shift - n * sizeof(T)));
+template <typename T, size_t N, typename Storage>
+T* StackAllocator<T, N, Storage>::allocate(size_t n) {
+  return static_cast<T*>(stack->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <typename T, size_t N, typename Storage>
+void StackAllocator<T, N, Storage>::deallocate(T* ptr, size_t n) {
+  stack->deallocate(ptr, n * sizeof(T), alignof(T));
 }
 
+//  Аллокаторы, которые позволяют освобождать по одному узлы, выделенные одним
+//  блоком: List выделяет под массовую вставку все узлы за один вызов
+template <typename Allocator>
+struct is_batch_allocator : std::false_type {};
+
+template <typename T, size_t N, typename Storage>
+struct is_batch_allocator<StackAllocator<T, N, Storage>> : std::true_type {};
+
+//  Узлы замкнуты в кольцо через sentinel_: у любого узла есть оба соседа,
+//  поэтому вставка и удаление обходятся без проверок на nullptr
 template <typename T, typename Allocator = std::allocator<T>>
 class List {
  private:
-  struct Node {
-    Node* previous = nullptr;
-    Node* next = nullptr;
+  struct BaseNode {
+    BaseNode* previous;
+    BaseNode* next;
+  };
+  struct Node : BaseNode {
     T value;
-    Node(Node* other)
-        : previous(other->previous),
-          next(other->next),
-          value(other->value) {
-    }
-    Node(Node* previous, Node* next, const T& value)
-        : previous(previous),
-          next(next),
-          value(value) {
-    }
-    Node(Node* previous, Node* next)
-        : previous(previous),
-          next(next) {
-    }
   };
   using NodeAllocator =
       typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
   using AllocatorTraits = std::allocator_traits<NodeAllocator>;
   [[no_unique_address]] NodeAllocator allocator_;
   size_t size_ = 0;
-  Node* begin_ = nullptr;
-  Node* end_ = nullptr;
-  Node* construct_node(const T& value);
-  Node* construct_default_node();
+  BaseNode sentinel_ = {&sentinel_, &sentinel_};
+  BaseNode* sentinel() const;
+  void fix_sentinel();
+  template <typename... Args>
+  Node* construct_node(Args&&... args);
+  void destroy_node(BaseNode* node);
+  template <typename Produce>
+  BaseNode* insert_chain(BaseNode* place, size_t n, Produce produce);
   void fill(size_t n, const T& element);
   void fill_default(size_t n);
+  void fill_copy(const List& other);
+  void erase_tail(BaseNode* node);
   void clear();
-  void swap(List& other);
+  void swap_nodes(List& other);
+  static void link_before(BaseNode* place, BaseNode* first, BaseNode* last);
+  static void unlink(BaseNode* first, BaseNode* last);
+  template <typename Compare>
+  static BaseNode* merge_chains(BaseNode* left, BaseNode* right,
+                                Compare& compare);
+  template <typename Compare>
+  static BaseNode* sort_chain(BaseNode* head, size_t count, Compare& compare);
+  void relink_chain(BaseNode* head);
+  template <typename U, typename A>
+  friend struct ParallelListSort;
+  template <typename Visit>
+  BaseNode* walk(Visit visit) const;
 
  public:
   template <bool is_const>
   struct basic_iterator {
-    Node* node;
-    const List* list;
+    BaseNode* node;
     typedef typename std::conditional<is_const, const T, T>::type value_type;
     typedef typename std::conditional<is_const, const T&, T&>::type reference;
     typedef typename std::conditional<is_const, const T*, T*>::type pointer;
     using iterator_category = std::bidirectional_iterator_tag;
     using difference_type = std::ptrdiff_t;
     basic_iterator() = default;
-    basic_iterator(Node* node, const List* list);
+    basic_iterator(BaseNode* node);
     basic_iterator& operator++();
     basic_iterator operator++(int);
     basic_iterator& operator--();
@@ -140,21 +529,55 @@ class List {
   using const_iterator = basic_iterator<true>;
   using reverse_iterator = std::reverse_iterator<iterator>;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  //  Владеет извлечённым узлом вместе с копией аллокатора, которым он выделен;
+  //  непустой дескриптор при разрушении уничтожает элемент и освобождает узел
+  class node_type {
+   public:
+    node_type() = default;
+    node_type(node_type&& other) noexcept;
+    node_type& operator=(node_type&& other) noexcept;
+    ~node_type();
+    bool empty() const;
+    explicit operator bool() const;
+    T& value() const;
+    Allocator get_allocator() const;
+
+   private:
+    friend class List;
+    node_type(Node* node, const NodeAllocator& allocator);
+    void reset();
+    Node* node_ = nullptr;
+    std::optional<NodeAllocator> allocator_;
+  };
   List() = default;
   List(size_t n);
   List(size_t n, const T& element);
   List(const Allocator& allocator);
   List(size_t n, const Allocator& allocator);
   List(size_t n, const T& element, const Allocator& allocator);
+  template <std::input_iterator InputIt>
+  List(InputIt first, InputIt last, const Allocator& allocator = Allocator());
   List(const List& other);
+  List(List&& other) noexcept;
   ~List();
   List& operator=(const List& other);
+  List& operator=(List&& other);
+  void swap(List& other);
+  void assign(size_t n, const T& element);
+  template <std::input_iterator InputIt>
+  void assign(InputIt first, InputIt last);
   Allocator get_allocator() const;
   size_t size() const;
   void push_back(const T& element);
+  void push_back(T&& element);
   void pop_back();
   void push_front(const T& element);
+  void push_front(T&& element);
   void pop_front();
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  template <typename... Args>
+  T& emplace_front(Args&&... args);
   iterator begin();
   const_iterator begin() const;
   const_iterator cbegin() const;
@@ -167,127 +590,272 @@ class List {
   reverse_iterator rend();
   const_reverse_iterator rend() const;
   const_reverse_iterator crend() const;
-  void insert(const const_iterator& iter, const T& element);
-  void erase(const const_iterator& iter);
+  iterator insert(const const_iterator& iter, const T& element);
+  iterator insert(const const_iterator& iter, T&& element);
+  iterator insert(const const_iterator& iter, size_t n, const T& element);
+  template <std::input_iterator InputIt>
+  iterator insert(const const_iterator& iter, InputIt first, InputIt last);
+  template <typename... Args>
+  iterator emplace(const const_iterator& iter, Args&&... args);
+  iterator erase(const const_iterator& iter);
+  node_type extract(const const_iterator& iter);
+  iterator insert(const const_iterator& iter, node_type&& handle);
+  iterator insert(node_type&& handle);
+  void release();
+  void splice(const const_iterator& pos, List& other);
+  void splice(const const_iterator& pos, List& other,
+              const const_iterator& iter);
+  void splice(const const_iterator& pos, List& other,
+              const const_iterator& first, const const_iterator& last);
+  void merge(List& other);
+  template <typename Compare>
+  void merge(List& other, Compare compare);
+  void sort();
+  template <typename Compare>
+  void sort(Compare compare);
+  template <typename Function>
+  Function for_each(Function function);
+  template <typename Function>
+  Function for_each(Function function) const;
+  template <typename U>
+  iterator find(const U& value);
+  template <typename U>
+  const_iterator find(const U& value) const;
+  template <typename U, typename BinaryOperation = std::plus<>>
+  U accumulate(U init, BinaryOperation operation = BinaryOperation()) const;
+  void compact();
 };
 
+//  end() константного списка тоже указывает на sentinel_, отсюда const_cast
 template <typename T, typename Allocator>
-typename List<T, Allocator>::Node* List<T, Allocator>::construct_node(
-    const T& element) {
-  Node* result = AllocatorTraits::allocate(allocator_, 1);
-  try {
-    AllocatorTraits::construct(allocator_, &(result->value), element);
-  } catch (...) {
-    AllocatorTraits::deallocate(allocator_, result, 1);
-    throw;
+typename List<T, Allocator>::BaseNode* List<T, Allocator>::sentinel() const {
+  return const_cast<BaseNode*>(&sentinel_);
+}
+
+//  После обмена содержимым sentinel_ соседи всё ещё ссылаются на чужой
+//  sentinel_, а пустой список должен замыкаться сам на себя
+template <typename T, typename Allocator>
+void List<T, Allocator>::fix_sentinel() {
+  if (size_ == 0) {
+    sentinel_.previous = &sentinel_;
+    sentinel_.next = &sentinel_;
+  } else {
+    sentinel_.next->previous = &sentinel_;
+    sentinel_.previous->next = &sentinel_;
   }
-  result->previous = nullptr;
-  result->next = nullptr;
-  return result;
 }
 
+//  Значение строится прямо в узле из переданных аргументов, без промежуточного T
 template <typename T, typename Allocator>
-typename List<T, Allocator>::Node*
-List<T, Allocator>::construct_default_node() {
+template <typename... Args>
+typename List<T, Allocator>::Node* List<T, Allocator>::construct_node(
+    Args&&... args) {
   Node* result = AllocatorTraits::allocate(allocator_, 1);
   try {
-    AllocatorTraits::construct(allocator_, &(result->value));
+    AllocatorTraits::construct(allocator_, &(result->value),
+                               std::forward<Args>(args)...);
   } catch (...) {
     AllocatorTraits::deallocate(allocator_, result, 1);
     throw;
   }
-  result->previous = nullptr;
-  result->next = nullptr;
   return result;
 }
 
 template <typename T, typename Allocator>
-void List<T, Allocator>::fill(size_t n, const T& element) {
-  try {
-    for (size_t i = 0; i < n; ++i) {
-      Node* node = construct_node(element);
-      if (begin_ == nullptr) {
-        begin_ = node;
-        end_ = node;
-      } else if (begin_->next == nullptr) {
-        begin_->next = node;
-        node->previous = begin_;
-        end_ = node;
-      } else {
-        node->previous = end_;
-        end_->next = node;
-        end_ = node;
+void List<T, Allocator>::destroy_node(BaseNode* node) {
+  Node* full = static_cast<Node*>(node);
+  AllocatorTraits::destroy(allocator_, &(full->value));
+  AllocatorTraits::deallocate(allocator_, full, 1);
+}
+
+//  Строит n узлов (produce конструирует значение по адресу) и вставляет их
+//  перед place одной перевязкой; при исключении список не меняется.
+//  Для is_batch_allocator все узлы берутся одним вызовом allocate
+template <typename T, typename Allocator>
+template <typename Produce>
+typename List<T, Allocator>::BaseNode* List<T, Allocator>::insert_chain(
+    BaseNode* place, size_t n, Produce produce) {
+  if (n == 0) {
+    return place;
+  }
+  BaseNode* first = nullptr;
+  BaseNode* last = nullptr;
+  if constexpr (is_batch_allocator<NodeAllocator>::value) {
+    Node* block = AllocatorTraits::allocate(allocator_, n);
+    size_t constructed = 0;
+    try {
+      for (; constructed < n; ++constructed) {
+        produce(&(block[constructed].value));
+        if (constructed > 0) {
+          block[constructed - 1].next = &block[constructed];
+          block[constructed].previous = &block[constructed - 1];
+        }
+      }
+    } catch (...) {
+      for (size_t i = 0; i < constructed; ++i) {
+        AllocatorTraits::destroy(allocator_, &(block[i].value));
       }
-      ++size_;
+      AllocatorTraits::deallocate(allocator_, block, n);
+      throw;
+    }
+    first = &block[0];
+    last = &block[n - 1];
+  } else {
+    try {
+      for (size_t i = 0; i < n; ++i) {
+        Node* node = AllocatorTraits::allocate(allocator_, 1);
+        try {
+          produce(&(node->value));
+        } catch (...) {
+          AllocatorTraits::deallocate(allocator_, node, 1);
+          throw;
+        }
+        if (first == nullptr) {
+          first = node;
+        } else {
+          last->next = node;
+          node->previous = last;
+        }
+        last = node;
+      }
+    } catch (...) {
+      while (first != nullptr) {
+        BaseNode* next = (first == last) ? nullptr : first->next;
+        destroy_node(first);
+        first = next;
+      }
+      throw;
     }
-  } catch (...) {
-    clear();
-    throw;
   }
+  link_before(place, first, last);
+  size_ += n;
+  return first;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::fill(size_t n, const T& element) {
+  insert_chain(&sentinel_, n, [this, &element](T* value) {
+    AllocatorTraits::construct(allocator_, value, element);
+  });
 }
 
 template <typename T, typename Allocator>
 void List<T, Allocator>::fill_default(size_t n) {
-  try {
-    for (size_t i = 0; i < n; ++i) {
-      Node* node = construct_default_node();
-      if (begin_ == nullptr) {
-        begin_ = node;
-        end_ = node;
-      } else if (begin_->next == nullptr) {
-        begin_->next = node;
-        node->previous = begin_;
-        end_ = node;
-      } else {
-        node->previous = end_;
-        end_->next = node;
-        end_ = node;
-      }
-      ++size_;
-    }
-  } catch (...) {
-    clear();
-    throw;
-  }
+  insert_chain(&sentinel_, n, [this](T* value) {
+    AllocatorTraits::construct(allocator_, value);
+  });
 }
 
 template <typename T, typename Allocator>
 void List<T, Allocator>::clear() {
-  Node* temporary = begin_;
-  while (temporary != nullptr) {
-    std::swap(begin_, temporary->next);
-    AllocatorTraits::destroy(allocator_, temporary);
-    AllocatorTraits::deallocate(allocator_, temporary, 1);
-    temporary = begin_;
-  }
-  end_ = nullptr;
+  BaseNode* node = sentinel_.next;
+  while (node != &sentinel_) {
+    BaseNode* next = node->next;
+    destroy_node(node);
+    node = next;
+  }
+  sentinel_.previous = &sentinel_;
+  sentinel_.next = &sentinel_;
   size_ = 0;
 }
 
+//  Размер известен, так что лишнего прохода на std::distance нет
 template <typename T, typename Allocator>
-void List<T, Allocator>::swap(List& other) {
+void List<T, Allocator>::fill_copy(const List& other) {
+  BaseNode* source = other.sentinel_.next;
+  insert_chain(&sentinel_, other.size_, [this, &source](T* value) {
+    AllocatorTraits::construct(allocator_, value,
+                               static_cast<Node*>(source)->value);
+    source = source->next;
+  });
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::erase_tail(BaseNode* node) {
+  while (node != &sentinel_) {
+    BaseNode* next = node->next;
+    erase(const_iterator(node));
+    node = next;
+  }
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::swap_nodes(List& other) {
   std::swap(size_, other.size_);
-  std::swap(begin_, other.begin_);
-  std::swap(end_, other.end_);
+  std::swap(sentinel_, other.sentinel_);
+  fix_sentinel();
+  other.fix_sentinel();
+}
+
+//  Вставляет уже связанную цепочку first..last перед place
+template <typename T, typename Allocator>
+void List<T, Allocator>::link_before(BaseNode* place, BaseNode* first,
+                                     BaseNode* last) {
+  BaseNode* previous = place->previous;
+  first->previous = previous;
+  last->next = place;
+  previous->next = first;
+  place->previous = last;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::unlink(BaseNode* first, BaseNode* last) {
+  first->previous->next = last->next;
+  last->next->previous = first->previous;
+}
+
+//  Слияние двух отсортированных цепочек по next; при равенстве первым идёт
+//  узел из left, поэтому сортировка устойчива
+template <typename T, typename Allocator>
+template <typename Compare>
+typename List<T, Allocator>::BaseNode* List<T, Allocator>::merge_chains(
+    BaseNode* left, BaseNode* right, Compare& compare) {
+  BaseNode* head = nullptr;
+  BaseNode** tail = &head;
+  while (left != nullptr && right != nullptr) {
+    if (compare(static_cast<Node*>(right)->value,
+                static_cast<Node*>(left)->value)) {
+      *tail = right;
+      right = right->next;
+    } else {
+      *tail = left;
+      left = left->next;
+    }
+    tail = &((*tail)->next);
+  }
+  *tail = (left != nullptr) ? left : right;
+  return head;
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+typename List<T, Allocator>::BaseNode* List<T, Allocator>::sort_chain(
+    BaseNode* head, size_t count, Compare& compare) {
+  if (count == 1) {
+    head->next = nullptr;
+    return head;
+  }
+  size_t half = count / 2;
+  BaseNode* middle = head;
+  for (size_t i = 0; i < half; ++i) {
+    middle = middle->next;
+  }
+  BaseNode* left = sort_chain(head, half, compare);
+  BaseNode* right = sort_chain(middle, count - half, compare);
+  return merge_chains(left, right, compare);
 }
 
 template <typename T, typename Allocator>
 template <bool is_const>
-List<T, Allocator>::basic_iterator<is_const>::basic_iterator(Node* node,
-                                                             const List* list)
-    : node(node),
-      list(list) {
+List<T, Allocator>::basic_iterator<is_const>::basic_iterator(BaseNode* node)
+    : node(node) {
 }
 
 template <typename T, typename Allocator>
 template <bool is_const>
 typename List<T, Allocator>::template basic_iterator<is_const>&
 List<T, Allocator>::basic_iterator<is_const>::operator++() {
-  if (node != nullptr) {
-    node = node->next;
-  } else {
-    node = list->begin_;
-  }
+  node = node->next;
   return *this;
 }
 
@@ -296,11 +864,7 @@ template <bool is_const>
 typename List<T, Allocator>::template basic_iterator<is_const>
 List<T, Allocator>::basic_iterator<is_const>::operator++(int) {
   basic_iterator copy = basic_iterator(*this);
-  if (node != nullptr) {
-    node = node->next;
-  } else {
-    node = list->begin_;
-  }
+  node = node->next;
   return copy;
 }
 
@@ -308,11 +872,7 @@ template <typename T, typename Allocator>
 template <bool is_const>
 typename List<T, Allocator>::template basic_iterator<is_const>&
 List<T, Allocator>::basic_iterator<is_const>::operator--() {
-  if (node != nullptr) {
-    node = node->previous;
-  } else {
-    node = list->end_;
-  }
+  node = node->previous;
   return *this;
 }
 
@@ -321,11 +881,7 @@ template <bool is_const>
 typename List<T, Allocator>::template basic_iterator<is_const>
 List<T, Allocator>::basic_iterator<is_const>::operator--(int) {
   basic_iterator copy = basic_iterator(*this);
-  if (node != nullptr) {
-    node = node->previous;
-  } else {
-    node = list->end_;
-  }
+  node = node->previous;
   return copy;
 }
 
@@ -347,28 +903,28 @@ template <typename T, typename Allocator>
 template <bool is_const>
 typename List<T, Allocator>::template basic_iterator<is_const>::reference
 List<T, Allocator>::basic_iterator<is_const>::operator*() const {
-  return node->value;
+  return static_cast<Node*>(node)->value;
 }
 
 template <typename T, typename Allocator>
 template <bool is_const>
 typename List<T, Allocator>::template basic_iterator<is_const>::pointer
 List<T, Allocator>::basic_iterator<is_const>::operator->() const {
-  return &(node->value);
+  return &(static_cast<Node*>(node)->value);
 }
 
 template <typename T, typename Allocator>
 template <bool is_const>
 List<T, Allocator>::basic_iterator<is_const>::operator List<
     T, Allocator>::basic_iterator<true>() const {
-  return basic_iterator<true>(node, list);
+  return basic_iterator<true>(node);
 }
 
 template <typename T, typename Allocator>
 template <bool is_const>
 typename List<T, Allocator>::template basic_iterator<is_const>
 List<T, Allocator>::basic_iterator<is_const>::base() const {
-  return basic_iterator<is_const>(node->next, list);
+  return basic_iterator<is_const>(node->next);
 }
 
 template <typename T, typename Allocator>
@@ -398,36 +954,24 @@ List<T, Allocator>::List(size_t n, const T& element, const Allocator& allocator)
   fill(n, element);
 }
 
+template <typename T, typename Allocator>
+template <std::input_iterator InputIt>
+List<T, Allocator>::List(InputIt first, InputIt last, const Allocator& allocator)
+    : allocator_(allocator) {
+  insert(cend(), first, last);
+}
+
 template <typename T, typename Allocator>
 List<T, Allocator>::List(const List& other)
     : allocator_(AllocatorTraits::select_on_container_copy_construction(
           other.allocator_)) {
-  if (other.size_ == 0) {
-    return;
-  }
-  try {
-    Node* cur_other = other.begin_;
-    for (size_t i = 0; i < other.size_; ++i) {
-      Node* node = construct_node(cur_other->value);
-      if (begin_ == nullptr) {
-        begin_ = node;
-        end_ = node;
-      } else if (begin_->next == nullptr) {
-        begin_->next = node;
-        node->previous = begin_;
-        end_ = node;
-      } else {
-        node->previous = end_;
-        end_->next = node;
-        end_ = node;
-      }
-      ++size_;
-      cur_other = cur_other->next;
-    }
-  } catch (...) {
-    clear();
-    throw;
-  }
+  fill_copy(other);
+}
+
+template <typename T, typename Allocator>
+List<T, Allocator>::List(List&& other) noexcept
+    : allocator_(std::move(other.allocator_)) {
+  swap_nodes(other);
 }
 
 template <typename T, typename Allocator>
@@ -440,15 +984,82 @@ List<T, Allocator>& List<T, Allocator>::operator=(const List& other) {
   if (this == &other) {
     return *this;
   }
-  if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::
-                    value) {
+  constexpr bool propagate =
+      AllocatorTraits::propagate_on_container_copy_assignment::value;
+  List temporary(propagate ? other.get_allocator() : get_allocator());
+  temporary.fill_copy(other);
+  clear();
+  if constexpr (propagate) {
     allocator_ = other.allocator_;
   }
-  List temporary(other);
-  swap(temporary);
+  swap_nodes(temporary);
+  return *this;
+}
+
+//  Узлы забираются без копирования, если аллокатор переезжает вместе с ними
+//  или аллокаторы равны; иначе элементы переносятся по одному в свою память
+template <typename T, typename Allocator>
+List<T, Allocator>& List<T, Allocator>::operator=(List&& other) {
+  if (this == &other) {
+    return *this;
+  }
+  clear();
+  if constexpr (AllocatorTraits::propagate_on_container_move_assignment::
+                    value) {
+    allocator_ = std::move(other.allocator_);
+    swap_nodes(other);
+  } else {
+    if (allocator_ == other.allocator_) {
+      swap_nodes(other);
+    } else {
+      for (BaseNode* node = other.sentinel_.next; node != &other.sentinel_;
+           node = node->next) {
+        push_back(std::move(static_cast<Node*>(node)->value));
+      }
+      other.clear();
+    }
+  }
   return *this;
 }
 
+//  Как и у std::list, при непропагируемом аллокаторе аллокаторы должны быть равны
+template <typename T, typename Allocator>
+void List<T, Allocator>::swap(List& other) {
+  if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+    std::swap(allocator_, other.allocator_);
+  }
+  swap_nodes(other);
+}
+
+//  Существующие узлы переиспользуются присваиванием, недостающие
+//  достраиваются одним блоком, лишние удаляются
+template <typename T, typename Allocator>
+void List<T, Allocator>::assign(size_t n, const T& element) {
+  iterator current = begin();
+  for (; current != end() && n > 0; ++current, --n) {
+    *current = element;
+  }
+  if (n > 0) {
+    insert(cend(), n, element);
+  } else {
+    erase_tail(current.node);
+  }
+}
+
+template <typename T, typename Allocator>
+template <std::input_iterator InputIt>
+void List<T, Allocator>::assign(InputIt first, InputIt last) {
+  iterator current = begin();
+  for (; current != end() && first != last; ++current, ++first) {
+    *current = *first;
+  }
+  if (first != last) {
+    insert(cend(), first, last);
+  } else {
+    erase_tail(current.node);
+  }
+}
+
 template <typename T, typename Allocator>
 Allocator List<T, Allocator>::get_allocator() const {
   return allocator_;
@@ -461,57 +1072,79 @@ size_t List<T, Allocator>::size() const {
 
 template <typename T, typename Allocator>
 void List<T, Allocator>::push_back(const T& element) {
-  insert({nullptr, this}, element);
+  insert(end(), element);
 }
 
 template <typename T, typename Allocator>
 void List<T, Allocator>::pop_back() {
-  erase({end_, this});
+  erase(const_iterator(sentinel_.previous));
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::push_back(T&& element) {
+  insert(end(), std::move(element));
 }
 
 template <typename T, typename Allocator>
 void List<T, Allocator>::push_front(const T& element) {
-  insert({begin_, this}, element);
+  insert(begin(), element);
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::push_front(T&& element) {
+  insert(begin(), std::move(element));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+T& List<T, Allocator>::emplace_back(Args&&... args) {
+  return *emplace(end(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+T& List<T, Allocator>::emplace_front(Args&&... args) {
+  return *emplace(begin(), std::forward<Args>(args)...);
 }
 
 template <typename T, typename Allocator>
 void List<T, Allocator>::pop_front() {
-  erase({begin_, this});
+  erase(begin());
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::iterator List<T, Allocator>::begin() {
-  return iterator(begin_, this);
+  return iterator(sentinel_.next);
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::const_iterator List<T, Allocator>::begin() const {
-  return const_iterator(begin_, this);
+  return const_iterator(sentinel_.next);
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::const_iterator List<T, Allocator>::cbegin() const {
-  return const_iterator(begin_, this);
+  return const_iterator(sentinel_.next);
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::iterator List<T, Allocator>::end() {
-  return iterator(end_->next, this);
+  return iterator(&sentinel_);
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::const_iterator List<T, Allocator>::end() const {
-  return const_iterator(end_->next, this);
+  return const_iterator(sentinel());
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::const_iterator List<T, Allocator>::cend() const {
-  return const_iterator(end_->next, this);
+  return const_iterator(sentinel());
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::reverse_iterator List<T, Allocator>::rbegin() {
-  return reverse_iterator(iterator(end_->next, this));
+  return reverse_iterator(end());
 }
 
 template <typename T, typename Allocator>
@@ -523,12 +1156,12 @@ typename List<T, Allocator>::const_reverse_iterator List<T, Allocator>::rbegin()
 template <typename T, typename Allocator>
 typename List<T, Allocator>::const_reverse_iterator
 List<T, Allocator>::crbegin() const {
-  return const_reverse_iterator(const_iterator(end_->next, this));
+  return const_reverse_iterator(cend());
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::reverse_iterator List<T, Allocator>::rend() {
-  return reverse_iterator(iterator(begin_, this));
+  return reverse_iterator(begin());
 }
 
 template <typename T, typename Allocator>
@@ -540,48 +1173,390 @@ typename List<T, Allocator>::const_reverse_iterator List<T, Allocator>::rend()
 template <typename T, typename Allocator>
 typename List<T, Allocator>::const_reverse_iterator List<T, Allocator>::crend()
     const {
-  return const_reverse_iterator(const_iterator(begin_, this));
+  return const_reverse_iterator(cbegin());
 }
 
 template <typename T, typename Allocator>
-void List<T, Allocator>::insert(const const_iterator& iter, const T& element) {
-  Node* node = construct_node(element);
-  Node* place = iter.node;
-  if (place == nullptr) {
-    if (end_ == nullptr) {
-      begin_ = node;
-      end_ = node;
-    } else {
-      end_->next = node;
-      node->previous = end_;
-      end_ = node;
-    }
+typename List<T, Allocator>::iterator List<T, Allocator>::insert(
+    const const_iterator& iter, const T& element) {
+  return emplace(iter, element);
+}
+
+template <typename T, typename Allocator>
+typename List<T, Allocator>::iterator List<T, Allocator>::insert(
+    const const_iterator& iter, T&& element) {
+  return emplace(iter, std::move(element));
+}
+
+template <typename T, typename Allocator>
+typename List<T, Allocator>::iterator List<T, Allocator>::insert(
+    const const_iterator& iter, size_t n, const T& element) {
+  return iterator(insert_chain(iter.node, n, [this, &element](T* value) {
+    AllocatorTraits::construct(allocator_, value, element);
+  }));
+}
+
+//  Для forward-итераторов длина известна заранее и узлы строятся одним
+//  блоком; однопроходный ввод собирается во временный список и переносится
+template <typename T, typename Allocator>
+template <std::input_iterator InputIt>
+typename List<T, Allocator>::iterator List<T, Allocator>::insert(
+    const const_iterator& iter, InputIt first, InputIt last) {
+  if constexpr (std::forward_iterator<InputIt>) {
+    size_t n = static_cast<size_t>(std::distance(first, last));
+    return iterator(insert_chain(iter.node, n, [this, &first](T* value) {
+      AllocatorTraits::construct(allocator_, value, *first);
+      ++first;
+    }));
   } else {
-    node->next = place;
-    node->previous = place->previous;
-    if (place->previous != nullptr) {
-      place->previous->next = node;
-    } else {
-      begin_ = node;
+    List temporary(get_allocator());
+    for (; first != last; ++first) {
+      temporary.emplace_back(*first);
     }
-    place->previous = node;
+    iterator result(iter.node->previous);
+    splice(iter, temporary);
+    return ++result;
   }
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+typename List<T, Allocator>::iterator List<T, Allocator>::emplace(
+    const const_iterator& iter, Args&&... args) {
+  Node* node = construct_node(std::forward<Args>(args)...);
+  link_before(iter.node, node, node);
   ++size_;
+  return iterator(node);
 }
 
 template <typename T, typename Allocator>
-void List<T, Allocator>::erase(const const_iterator& iter) {
-  if (iter.node->previous != nullptr) {
-    iter.node->previous->next = iter.node->next;
-  } else {
-    begin_ = iter.node->next;
+typename List<T, Allocator>::iterator List<T, Allocator>::erase(
+    const const_iterator& iter) {
+  BaseNode* next = iter.node->next;
+  unlink(iter.node, iter.node);
+  destroy_node(iter.node);
+  --size_;
+  return iterator(next);
+}
+
+template <typename T, typename Allocator>
+List<T, Allocator>::node_type::node_type(Node* node,
+                                         const NodeAllocator& allocator)
+    : node_(node),
+      allocator_(allocator) {
+}
+
+template <typename T, typename Allocator>
+List<T, Allocator>::node_type::node_type(node_type&& other) noexcept
+    : node_(other.node_),
+      allocator_(std::move(other.allocator_)) {
+  other.node_ = nullptr;
+  other.allocator_.reset();
+}
+
+template <typename T, typename Allocator>
+typename List<T, Allocator>::node_type& List<T, Allocator>::node_type::operator=(
+    node_type&& other) noexcept {
+  if (this != &other) {
+    reset();
+    node_ = other.node_;
+    allocator_ = std::move(other.allocator_);
+    other.node_ = nullptr;
+    other.allocator_.reset();
   }
-  if (iter.node->next != nullptr) {
-    iter.node->next->previous = iter.node->previous;
-  } else {
-    end_ = iter.node->previous;
+  return *this;
+}
+
+template <typename T, typename Allocator>
+List<T, Allocator>::node_type::~node_type() {
+  reset();
+}
+
+template <typename T, typename Allocator>
+bool List<T, Allocator>::node_type::empty() const {
+  return node_ == nullptr;
+}
+
+template <typename T, typename Allocator>
+List<T, Allocator>::node_type::operator bool() const {
+  return node_ != nullptr;
+}
+
+template <typename T, typename Allocator>
+T& List<T, Allocator>::node_type::value() const {
+  return node_->value;
+}
+
+template <typename T, typename Allocator>
+Allocator List<T, Allocator>::node_type::get_allocator() const {
+  return Allocator(*allocator_);
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::node_type::reset() {
+  if (node_ != nullptr) {
+    AllocatorTraits::destroy(*allocator_, &(node_->value));
+    AllocatorTraits::deallocate(*allocator_, node_, 1);
+    node_ = nullptr;
   }
-  AllocatorTraits::destroy(allocator_, iter.node);
-  AllocatorTraits::deallocate(allocator_, iter.node, 1);
+  allocator_.reset();
+}
+
+//  Узел отвязывается без уничтожения элемента и освобождения памяти
+template <typename T, typename Allocator>
+typename List<T, Allocator>::node_type List<T, Allocator>::extract(
+    const const_iterator& iter) {
+  unlink(iter.node, iter.node);
   --size_;
+  return node_type(static_cast<Node*>(iter.node), allocator_);
+}
+
+//  При равных аллокаторах узел просто перевязывается; иначе элемент
+//  переносится в новый узел своего аллокатора, а старый освобождается
+//  дескриптором. Пустой дескриптор ничего не вставляет и возвращает iter
+template <typename T, typename Allocator>
+typename List<T, Allocator>::iterator List<T, Allocator>::insert(
+    const const_iterator& iter, node_type&& handle) {
+  if (handle.empty()) {
+    return iterator(iter.node);
+  }
+  if (!(*handle.allocator_ == allocator_)) {
+    iterator result = emplace(iter, std::move(handle.value()));
+    handle.reset();
+    return result;
+  }
+  Node* node = handle.node_;
+  handle.node_ = nullptr;
+  handle.allocator_.reset();
+  link_before(iter.node, node, node);
+  ++size_;
+  return iterator(node);
+}
+
+template <typename T, typename Allocator>
+typename List<T, Allocator>::iterator List<T, Allocator>::insert(
+    node_type&& handle) {
+  return insert(cend(), std::move(handle));
+}
+
+//  Забывает все узлы, не обходя их: память должна освобождаться разом
+//  (StackStorage::Marker или reset), поэтому только для тривиально разрушаемых T
+template <typename T, typename Allocator>
+void List<T, Allocator>::release() {
+  static_assert(std::is_trivially_destructible_v<T>,
+                "List::release skips destructors");
+  sentinel_.previous = &sentinel_;
+  sentinel_.next = &sentinel_;
+  size_ = 0;
+}
+
+//  splice, merge и sort только перевязывают узлы, ничего не выделяя; для
+//  переноса между списками их аллокаторы должны быть равны
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(const const_iterator& pos, List& other) {
+  splice(pos, other, other.cbegin(), other.cend());
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(const const_iterator& pos, List& other,
+                                const const_iterator& iter) {
+  if (iter.node == pos.node) {
+    return;
+  }
+  unlink(iter.node, iter.node);
+  --other.size_;
+  link_before(pos.node, iter.node, iter.node);
+  ++size_;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(const const_iterator& pos, List& other,
+                                const const_iterator& first,
+                                const const_iterator& last) {
+  if (first == last) {
+    return;
+  }
+  BaseNode* last_node = last.node->previous;
+  size_t count = 1;
+  if (&other != this) {
+    for (BaseNode* node = first.node; node != last_node; node = node->next) {
+      ++count;
+    }
+  }
+  unlink(first.node, last_node);
+  link_before(pos.node, first.node, last_node);
+  if (&other != this) {
+    other.size_ -= count;
+    size_ += count;
+  }
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::merge(List& other) {
+  merge(other, std::less<T>());
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void List<T, Allocator>::merge(List& other, Compare compare) {
+  if (&other == this) {
+    return;
+  }
+  BaseNode* current = sentinel_.next;
+  while (other.sentinel_.next != &other.sentinel_) {
+    BaseNode* incoming = other.sentinel_.next;
+    if (current == &sentinel_ ||
+        compare(static_cast<Node*>(incoming)->value,
+                static_cast<Node*>(current)->value)) {
+      unlink(incoming, incoming);
+      link_before(current, incoming, incoming);
+    } else {
+      current = current->next;
+    }
+  }
+  size_ += other.size_;
+  other.size_ = 0;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::sort() {
+  sort(std::less<T>());
+}
+
+//  Кольцо размыкается в цепочку по next, она сортируется слиянием (устойчиво),
+//  затем восстанавливаются previous и кольцо замыкается через sentinel_
+template <typename T, typename Allocator>
+template <typename Compare>
+void List<T, Allocator>::sort(Compare compare) {
+  if (size_ < 2) {
+    return;
+  }
+  sentinel_.previous->next = nullptr;
+  relink_chain(sort_chain(sentinel_.next, size_, compare));
+}
+
+//  Восстанавливает previous по отсортированной цепочке и замыкает кольцо
+template <typename T, typename Allocator>
+void List<T, Allocator>::relink_chain(BaseNode* head) {
+  BaseNode* previous = &sentinel_;
+  for (BaseNode* node = head; node != nullptr; node = node->next) {
+    node->previous = previous;
+    previous->next = node;
+    previous = node;
+  }
+  previous->next = &sentinel_;
+  sentinel_.previous = previous;
+}
+
+//  Общий обход for_each/find/accumulate. Упреждающей подгрузки здесь нет:
+//  курсор впереди сам идёт по той же цепочке ->next и обогнать основной не
+//  может (на перемешанном списке такой обход был медленнее простого), а
+//  локальность узлам возвращает compact(). visit возвращает true, чтобы
+//  остановиться; результат - узел остановки или sentinel
+template <typename T, typename Allocator>
+template <typename Visit>
+typename List<T, Allocator>::BaseNode* List<T, Allocator>::walk(
+    Visit visit) const {
+  BaseNode* end = sentinel();
+  for (BaseNode* node = end->next; node != end; node = node->next) {
+    if (visit(static_cast<Node*>(node))) {
+      return node;
+    }
+  }
+  return end;
+}
+
+template <typename T, typename Allocator>
+template <typename Function>
+Function List<T, Allocator>::for_each(Function function) {
+  walk([&function](Node* node) {
+    function(node->value);
+    return false;
+  });
+  return function;
+}
+
+template <typename T, typename Allocator>
+template <typename Function>
+Function List<T, Allocator>::for_each(Function function) const {
+  walk([&function](const Node* node) {
+    function(node->value);
+    return false;
+  });
+  return function;
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+typename List<T, Allocator>::iterator List<T, Allocator>::find(
+    const U& value) {
+  return iterator(walk([&value](const Node* node) {
+    return node->value == value;
+  }));
+}
+
+template <typename T, typename Allocator>
+template <typename U>
+typename List<T, Allocator>::const_iterator List<T, Allocator>::find(
+    const U& value) const {
+  return const_iterator(walk([&value](const Node* node) {
+    return node->value == value;
+  }));
+}
+
+template <typename T, typename Allocator>
+template <typename U, typename BinaryOperation>
+U List<T, Allocator>::accumulate(U init, BinaryOperation operation) const {
+  walk([&init, &operation](const Node* node) {
+    init = operation(std::move(init), node->value);
+    return false;
+  });
+  return init;
+}
+
+//  Узлы остаются на своих местах в памяти, но перевязываются в порядке
+//  возрастания адресов, а значения переставляются по циклам перестановки так,
+//  что порядок элементов не меняется. После интенсивных вставок и удалений
+//  обход снова идёт по буферу StackStorage вперёд, и новой памяти из арены не
+//  требуется. Все итераторы и ссылки на элементы становятся недействительными;
+//  если перемещение T бросает исключение, список остаётся корректным, но
+//  порядок элементов не определён
+template <typename T, typename Allocator>
+void List<T, Allocator>::compact() {
+  if (size_ < 2) {
+    return;
+  }
+  std::vector<BaseNode*> nodes;
+  nodes.reserve(size_);
+  for (BaseNode* node = sentinel_.next; node != &sentinel_; node = node->next) {
+    nodes.push_back(node);
+  }
+  std::vector<size_t> order(size_);
+  std::iota(order.begin(), order.end(), size_t(0));
+  std::sort(order.begin(), order.end(), [&nodes](size_t left, size_t right) {
+    return std::less<BaseNode*>()(nodes[left], nodes[right]);
+  });
+  BaseNode* previous = &sentinel_;
+  for (size_t index : order) {
+    previous->next = nodes[index];
+    nodes[index]->previous = previous;
+    previous = nodes[index];
+  }
+  previous->next = &sentinel_;
+  sentinel_.previous = previous;
+  //  Значение i-го элемента переезжает в узел nodes[order[i]]
+  using std::swap;
+  for (size_t start = 0; start < size_; ++start) {
+    if (order[start] == start) {
+      continue;
+    }
+    T carried = std::move(static_cast<Node*>(nodes[start])->value);
+    size_t current = start;
+    do {
+      size_t next = order[current];
+      order[current] = current;
+      current = next;
+      swap(carried, static_cast<Node*>(nodes[current])->value);
+    } while (current != start);
+  }
 }
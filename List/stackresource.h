@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+#include "stackallocator.h"
+
+//  std::pmr::memory_resource поверх StackStorage<N>: размер буфера стирается
+//  до виртуального вызова при выделении, поэтому контейнеры с
+//  std::pmr::polymorphic_allocator (включая List) над хранилищами разного N
+//  имеют один тип. Ресурсы не владеют хранилищем и равны только самим себе.
+
+//  Монотонный: память только выделяется, deallocate ничего не делает,
+//  освобождение - через StackStorage::Marker или reset()
+template <size_t N>
+class MonotonicStackResource : public std::pmr::memory_resource {
+ public:
+  explicit MonotonicStackResource(StackStorage<N>& storage);
+  StackStorage<N>& storage() const;
+
+ private:
+  StackStorage<N>& storage_;
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override;
+};
+
+//  С пулами: освобождённые блоки возвращаются в списки свободных блоков
+//  StackStorage по классам размера и переиспользуются
+template <size_t N>
+class PooledStackResource : public std::pmr::memory_resource {
+ public:
+  explicit PooledStackResource(StackStorage<N>& storage);
+  StackStorage<N>& storage() const;
+
+ private:
+  StackStorage<N>& storage_;
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override;
+};
+
+template <size_t N>
+MonotonicStackResource<N>::MonotonicStackResource(StackStorage<N>& storage)
+    : storage_(storage) {
+}
+
+template <size_t N>
+StackStorage<N>& MonotonicStackResource<N>::storage() const {
+  return storage_;
+}
+
+template <size_t N>
+void* MonotonicStackResource<N>::do_allocate(size_t bytes, size_t alignment) {
+  return storage_.allocate(bytes, alignment);
+}
+
+template <size_t N>
+void MonotonicStackResource<N>::do_deallocate(void*, size_t, size_t) {
+}
+
+template <size_t N>
+bool MonotonicStackResource<N>::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+template <size_t N>
+PooledStackResource<N>::PooledStackResource(StackStorage<N>& storage)
+    : storage_(storage) {
+}
+
+template <size_t N>
+StackStorage<N>& PooledStackResource<N>::storage() const {
+  return storage_;
+}
+
+template <size_t N>
+void* PooledStackResource<N>::do_allocate(size_t bytes, size_t alignment) {
+  return storage_.allocate(bytes, alignment);
+}
+
+template <size_t N>
+void PooledStackResource<N>::do_deallocate(void* ptr, size_t bytes,
+                                           size_t alignment) {
+  storage_.deallocate(ptr, bytes, alignment);
+}
+
+template <size_t N>
+bool PooledStackResource<N>::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
@@ -0,0 +1,1019 @@
+#include "concurrentqueue.h"
+#include "intrusivelist.h"
+#include "parallellist.h"
+#include "skiplist.h"
+#include "slaballocator.h"
+#include "stackallocator.h"
+#include "stackresource.h"
+#include "unrolledlist.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+void TestFreeListReuse() {
+  StackStorage<1024> storage;
+  StackAllocator<int, 1024> allocator(storage);
+  List<int, StackAllocator<int, 1024>> list(allocator);
+  for (int i = 0; i < 4; ++i) {
+    list.push_back(i);
+  }
+  for (int i = 4; i < 100000; ++i) {
+    list.push_back(i);
+    list.pop_front();
+  }
+  assert(list.size() == 4);
+  assert(*list.begin() == 99996);
+  assert(storage.shift < 1024);
+}
+
+void TestStorageSizeClasses() {
+  StackStorage<1024> storage;
+  void* first = storage.allocate(24, 8);
+  void* second = storage.allocate(40, 8);
+  storage.allocate(8, 8);
+  storage.deallocate(first, 24);
+  storage.deallocate(second, 40);
+  assert(storage.allocate(40, 8) == second);
+  assert(storage.allocate(17, 8) == first);
+  size_t shift = storage.shift;
+  void* top = storage.allocate(16, 8);
+  storage.deallocate(top, 16);
+  assert(storage.shift == shift);
+}
+
+void TestHeapFallback() {
+  using Storage = StackStorage<64>;
+  Storage fixed;
+  List<int, StackAllocator<int, 64>> small_list{StackAllocator<int, 64>(fixed)};
+  bool thrown = false;
+  try {
+    for (int i = 0; i < 100; ++i) {
+      small_list.push_back(i);
+    }
+  } catch (const std::bad_alloc&) {
+    thrown = true;
+  }
+  assert(thrown);
+  Storage growing(Storage::Mode::GROWING);
+  List<int, StackAllocator<int, 64>> list{StackAllocator<int, 64>(growing)};
+  for (int i = 0; i < 1000; ++i) {
+    list.push_back(i);
+  }
+  int expected = 0;
+  for (int value : list) {
+    assert(value == expected++);
+  }
+  assert(expected == 1000);
+  assert(growing.chunks != nullptr && growing.chunks->size >= 2 * 64);
+}
+
+struct alignas(64) CacheLine {
+  int value;
+  CacheLine(int value) : value(value) {}
+};
+
+void TestAlignment() {
+  StackStorage<4096> storage;
+  StackAllocator<char, 4096> chars(storage);
+  StackAllocator<short, 4096> shorts(chars);
+  StackAllocator<int, 4096> ints(chars);
+  StackAllocator<double, 4096> doubles(chars);
+  size_t start = storage.shift;
+  doubles.allocate(1);
+  ints.allocate(2);
+  shorts.allocate(3);
+  chars.allocate(2);
+  doubles.allocate(1);
+  ints.allocate(1);
+  chars.allocate(4);
+  assert(storage.shift - start == 8 + 8 + 6 + 2 + 8 + 4 + 4);
+  chars.allocate(1);
+  double* aligned = doubles.allocate(1);
+  assert(reinterpret_cast<uintptr_t>(aligned) % alignof(double) == 0);
+  StackAllocator<CacheLine, 4096> lines(chars);
+  CacheLine* line = lines.allocate(2);
+  assert(reinterpret_cast<uintptr_t>(line) % 64 == 0);
+  List<CacheLine, StackAllocator<CacheLine, 4096>> list(lines);
+  for (int i = 0; i < 8; ++i) {
+    list.push_back(CacheLine(i));
+  }
+  for (const CacheLine& element : list) {
+    assert(reinterpret_cast<uintptr_t>(&element) % 64 == 0);
+  }
+}
+
+void TestMarker() {
+  using Storage = StackStorage<1024>;
+  Storage storage(Storage::Mode::GROWING);
+  StackAllocator<int, 1024> allocator(storage);
+  List<int, StackAllocator<int, 1024>> outer(allocator);
+  outer.push_back(1);
+  size_t shift = storage.shift;
+  for (int round = 0; round < 3; ++round) {
+    Storage::Marker marker(storage);
+    List<int, StackAllocator<int, 1024>> batch(allocator);
+    for (int i = 0; i < 1000; ++i) {
+      batch.push_back(i);
+    }
+    assert(storage.chunks != nullptr);
+    batch.release();
+    assert(batch.size() == 0);
+  }
+  assert(storage.shift == shift);
+  assert(storage.chunks == nullptr);
+  assert(*outer.begin() == 1);
+  outer.release();
+  storage.reset();
+  assert(storage.shift == 0);
+}
+
+void TestSharedStorages() {
+  const size_t threads = 4, blocks = 1000, size = 1 << 20;
+  static AtomicStackStorage<size> shared;
+  std::vector<std::thread> workers;
+  std::vector<std::vector<size_t*>> results(threads);
+  for (size_t id = 0; id < threads; ++id) {
+    workers.emplace_back([id, &results] {
+      AtomicStackAllocator<size_t, size> allocator(shared);
+      for (size_t i = 0; i < blocks; ++i) {
+        size_t* block = allocator.allocate(3);
+        block[0] = block[1] = block[2] = id;
+        results[id].push_back(block);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  for (size_t id = 0; id < threads; ++id) {
+    for (size_t* block : results[id]) {
+      assert(block[0] == id && block[1] == id && block[2] == id);
+    }
+  }
+  assert(shared.shift == threads * blocks * 3 * sizeof(size_t));
+  StackStorage<256>* main_storage = &thread_local_storage<256>();
+  StackStorage<256>* worker_storage = nullptr;
+  std::thread worker([&worker_storage] {
+    StackAllocator<int, 256> allocator(thread_local_storage<256>());
+    List<int, StackAllocator<int, 256>> list(allocator);
+    for (int i = 0; i < 100; ++i) {
+      list.push_back(i);
+    }
+    worker_storage = &thread_local_storage<256>();
+  });
+  worker.join();
+  assert(worker_storage != main_storage);
+  assert(&thread_local_storage<256>() == main_storage);
+}
+
+template <typename List>
+std::vector<int> Collect(const List& list) {
+  std::vector<int> result;
+  for (auto iter = list.begin(); iter != list.end(); ++iter) {
+    result.push_back(*iter);
+  }
+  return result;
+}
+
+void TestMoveAndSwap() {
+  List<int> first;
+  for (int i = 0; i < 5; ++i) {
+    first.push_back(i);
+  }
+  const int* address = &*first.begin();
+  List<int> second(std::move(first));
+  assert(first.size() == 0 && second.size() == 5);
+  assert(&*second.begin() == address);
+  List<int> third;
+  third.push_back(42);
+  third = std::move(second);
+  assert(&*third.begin() == address);
+  assert((Collect(third) == std::vector<int>{0, 1, 2, 3, 4}));
+  List<int> copy;
+  copy = third;
+  assert(Collect(copy) == Collect(third) && &*copy.begin() != address);
+  copy.swap(second);
+  assert(copy.size() == 0 && second.size() == 5);
+
+  using Allocator = StackAllocator<int, 4096>;
+  StackStorage<4096> storage1, storage2;
+  List<int, Allocator> in_first{Allocator(storage1)};
+  List<int, Allocator> also_first{Allocator(storage1)};
+  List<int, Allocator> in_second{Allocator(storage2)};
+  for (int i = 0; i < 3; ++i) {
+    in_first.push_back(i);
+  }
+  address = &*in_first.begin();
+  also_first = std::move(in_first);
+  assert(&*also_first.begin() == address);
+  size_t shift = storage2.shift;
+  in_second = std::move(also_first);
+  assert((Collect(in_second) == std::vector<int>{0, 1, 2}));
+  assert(storage2.shift > shift && also_first.size() == 0);
+  in_second = in_second;
+  assert(in_second.size() == 3);
+}
+
+void TestSpliceMergeSort() {
+  List<int> first, second;
+  for (int i = 0; i < 4; ++i) {
+    first.push_back(i);
+    second.push_back(10 + i);
+  }
+  const int* moved = &*(++second.begin());
+  first.splice(first.begin(), second, ++second.begin());
+  assert((Collect(first) == std::vector<int>{11, 0, 1, 2, 3}));
+  assert(&*first.begin() == moved && second.size() == 3);
+  first.splice(first.end(), second);
+  assert((Collect(first) == std::vector<int>{11, 0, 1, 2, 3, 10, 12, 13}));
+  assert(second.size() == 0 && first.size() == 8);
+  second.splice(second.end(), first, ++first.begin(), first.end());
+  assert((Collect(second) == std::vector<int>{0, 1, 2, 3, 10, 12, 13}));
+  assert(first.size() == 1 && second.size() == 7);
+  first.splice(first.begin(), first, first.begin());
+  first.merge(second);
+  assert((Collect(first) == std::vector<int>{0, 1, 2, 3, 10, 11, 12, 13}));
+  assert(first.size() == 8 && second.size() == 0);
+
+  List<int> unsorted;
+  std::vector<int> values = {5, -3, 8, 5, 0, 12, -3, 7, 1};
+  for (int value : values) {
+    unsorted.push_back(value);
+  }
+  std::vector<const int*> addresses;
+  for (const int& value : unsorted) {
+    addresses.push_back(&value);
+  }
+  unsorted.sort();
+  std::vector<int> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  assert(Collect(unsorted) == sorted);
+  assert(&*unsorted.begin() == addresses[1] && &*(++unsorted.begin()) == addresses[6]);
+  std::vector<int> reversed = Collect(unsorted);
+  std::reverse(reversed.begin(), reversed.end());
+  std::vector<int> backwards;
+  for (auto iter = unsorted.rbegin(); iter != unsorted.rend(); ++iter) {
+    backwards.push_back(*iter);
+  }
+  assert(backwards == reversed);
+  unsorted.sort(std::greater<int>());
+  assert(Collect(unsorted) == reversed);
+}
+
+struct Counted {
+  static int copies;
+  static int moves;
+  std::string name;
+  int id;
+  Counted(const std::string& name, int id) : name(name), id(id) {}
+  Counted(const Counted& other) : name(other.name), id(other.id) {
+    ++copies;
+  }
+  Counted(Counted&& other) noexcept : name(std::move(other.name)), id(other.id) {
+    ++moves;
+  }
+};
+
+int Counted::copies = 0;
+int Counted::moves = 0;
+
+void TestEmplace() {
+  List<Counted> list;
+  list.emplace_back("b", 2);
+  list.emplace_front("a", 1);
+  auto iter = list.emplace(++list.begin(), "middle", 3);
+  assert(iter->name == "middle" && list.size() == 3);
+  assert(Counted::copies == 0 && Counted::moves == 0);
+  list.push_back(Counted("c", 4));
+  list.push_front(Counted("z", 0));
+  assert(list.insert(list.end(), Counted("d", 5))->name == "d");
+  assert(Counted::copies == 0 && Counted::moves == 3);
+  Counted e("e", 6);
+  list.push_back(e);
+  assert(Counted::copies == 1);
+  std::vector<std::string> names;
+  for (const Counted& element : list) {
+    names.push_back(element.name);
+  }
+  assert((names == std::vector<std::string>{"z", "a", "middle", "b", "c", "d", "e"}));
+
+  List<std::unique_ptr<int>> pointers;
+  pointers.emplace_back(new int(1));
+  pointers.push_back(std::make_unique<int>(2));
+  int& front = *pointers.emplace_front(std::make_unique<int>(0));
+  assert(front == 0);
+  List<std::unique_ptr<int>> moved(std::move(pointers));
+  int expected = 0;
+  for (const std::unique_ptr<int>& pointer : moved) {
+    assert(*pointer == expected++);
+  }
+}
+
+void TestSentinel() {
+  static_assert(sizeof(List<int>::iterator) == sizeof(void*));
+  List<int> empty;
+  assert(empty.begin() == empty.end() && empty.rbegin() == empty.rend());
+  empty.push_back(1);
+  empty.push_front(0);
+  assert(*--empty.end() == 1 && *empty.rbegin() == 1);
+  empty.pop_back();
+  empty.pop_front();
+  assert(empty.size() == 0 && empty.begin() == empty.end());
+  List<int> moved(std::move(empty));
+  moved.push_back(7);
+  assert((Collect(moved) == std::vector<int>{7}));
+  List<int> other;
+  other.swap(moved);
+  other.push_back(8);
+  assert((Collect(other) == std::vector<int>{7, 8}) && moved.begin() == moved.end());
+}
+
+void TestUnrolledList() {
+  UnrolledList<int, 4> list;
+  std::vector<int> expected;
+  for (int i = 0; i < 10; ++i) {
+    list.push_back(i);
+    expected.push_back(i);
+  }
+  assert(Collect(list) == expected);
+  auto middle = list.begin();
+  std::advance(middle, 3);
+  assert(*list.insert(middle, 100) == 100);
+  expected.insert(expected.begin() + 3, 100);
+  list.push_front(-1);
+  expected.insert(expected.begin(), -1);
+  assert(Collect(list) == expected && list.size() == expected.size());
+  auto iter = list.begin();
+  std::advance(iter, 5);
+  iter = list.erase(iter);
+  expected.erase(expected.begin() + 5);
+  assert(*iter == expected[5] && Collect(list) == expected);
+  while (list.size() > 2) {
+    list.pop_back();
+    list.pop_front();
+    expected.pop_back();
+    expected.erase(expected.begin());
+  }
+  assert(Collect(list) == expected);
+  assert(*list.rbegin() == expected[1] && *--list.end() == expected[1]);
+
+  using Allocator = StackAllocator<std::string, 1 << 16>;
+  StackStorage<1 << 16> storage;
+  UnrolledList<std::string, 3, Allocator> strings{Allocator(storage)};
+  for (int i = 0; i < 7; ++i) {
+    strings.emplace_front(20, static_cast<char>('a' + i));
+  }
+  auto inner = ++strings.begin();
+  bool thrown = false;
+  try {
+    strings.emplace(inner, std::string::npos, 'x');
+  } catch (const std::length_error&) {
+    thrown = true;
+  }
+  assert(thrown && strings.size() == 7);
+  std::vector<std::string> letters;
+  for (const std::string& value : strings) {
+    letters.push_back(value);
+  }
+  assert(letters.size() == 7 && letters[1] == std::string(20, 'f'));
+  strings.emplace(++strings.begin(), *strings.begin());
+  assert(*++strings.begin() == std::string(20, 'g'));
+  strings.erase(++strings.begin());
+  UnrolledList<std::string, 3, Allocator> copy = strings;
+  assert(copy.size() == 7 && *copy.begin() == std::string(20, 'g'));
+  UnrolledList<std::string, 3, Allocator> moved(std::move(copy));
+  assert(copy.size() == 0 && copy.begin() == copy.end() && moved.size() == 7);
+  while (moved.size() > 0) {
+    moved.erase(moved.begin());
+  }
+  assert(moved.begin() == moved.end());
+}
+
+struct ThrowOnCopy {
+  int value;
+  static int copies_left;
+  ThrowOnCopy(int value) : value(value) {
+  }
+  ThrowOnCopy(const ThrowOnCopy& other) : value(other.value) {
+    if (copies_left-- == 0) {
+      throw std::runtime_error("copy");
+    }
+  }
+};
+
+int ThrowOnCopy::copies_left = 1 << 20;
+
+void TestUnrolledListSplit() {
+  UnrolledList<std::string, 4> strings;
+  for (int i = 0; i < 4; ++i) {
+    strings.push_back(std::string(20, static_cast<char>('a' + i)));
+  }
+  strings.insert(strings.begin(), *std::prev(strings.end()));
+  strings.insert(strings.begin(), *std::prev(strings.end()));
+  std::vector<std::string> values(strings.begin(), strings.end());
+  assert(values.size() == 6 && values[0] == std::string(20, 'd') &&
+         values[1] == std::string(20, 'd') && values[5] == std::string(20, 'd'));
+
+  UnrolledList<ThrowOnCopy, 4> list;
+  for (int i = 0; i < 4; ++i) {
+    list.emplace_back(i);
+  }
+  ThrowOnCopy::copies_left = 1;
+  bool thrown = false;
+  try {
+    list.emplace(list.begin(), 9);
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  ThrowOnCopy::copies_left = 1 << 20;
+  assert(thrown && list.size() == 4);
+  int expected = 0;
+  for (const ThrowOnCopy& element : list) {
+    assert(element.value == expected++);
+  }
+  assert(expected == 4);
+}
+
+void TestBulkInsert() {
+  std::vector<int> source = {1, 2, 3, 4, 5};
+  List<int> list(source.begin(), source.end());
+  assert(Collect(list) == source);
+  auto position = list.begin();
+  ++position;
+  std::vector<int> extra = {10, 11};
+  auto inserted = list.insert(position, extra.begin(), extra.end());
+  assert(*inserted == 10);
+  assert((Collect(list) == std::vector<int>{1, 10, 11, 2, 3, 4, 5}));
+  //  Фигурные скобки по-прежнему означают размер и заполнитель
+  assert(List<size_t>{3}.size() == 3);
+  assert((Collect(List<int>{2, 7}) == std::vector<int>{7, 7}));
+  std::istringstream input("7 8 9");
+  inserted = list.insert(list.cend(), std::istream_iterator<int>(input),
+                         std::istream_iterator<int>());
+  assert(*inserted == 7 && list.size() == 10);
+  std::vector<int> replacement = {4, 3};
+  list.assign(replacement.begin(), replacement.end());
+  assert((Collect(list) == std::vector<int>{4, 3}));
+  list.assign(4, 0);
+  assert((Collect(list) == std::vector<int>{0, 0, 0, 0}));
+
+  using Allocator = StackAllocator<int, 4096>;
+  StackStorage<4096> storage;
+  std::vector<int> initial = {1, 2, 3, 4};
+  List<int, Allocator> batched(initial.begin(), initial.end(),
+                               Allocator(storage));
+  std::vector<const int*> addresses;
+  for (const int& value : batched) {
+    addresses.push_back(&value);
+  }
+  for (size_t i = 1; i < addresses.size(); ++i) {
+    assert(reinterpret_cast<const char*>(addresses[i]) -
+               reinterpret_cast<const char*>(addresses[i - 1]) ==
+           reinterpret_cast<const char*>(addresses[1]) -
+               reinterpret_cast<const char*>(addresses[0]));
+  }
+  auto second = batched.begin();
+  ++second;
+  auto after = batched.erase(second);
+  assert(after == ++batched.begin() && *after == 3);
+  batched.push_back(5);
+  assert(&*--batched.end() == addresses[1]);
+  List<int, Allocator> copy = batched;
+  assert((Collect(copy) == std::vector<int>{1, 3, 4, 5}));
+
+  std::vector<ThrowOnCopy> throwing = {1, 2, 3};
+  List<ThrowOnCopy> plain;
+  plain.push_back(0);
+  StackStorage<4096> throwing_storage;
+  using ThrowingAllocator = StackAllocator<ThrowOnCopy, 4096>;
+  List<ThrowOnCopy, ThrowingAllocator> stacked{
+      ThrowingAllocator(throwing_storage)};
+  stacked.push_back(0);
+  ThrowOnCopy::copies_left = 2;
+  bool thrown = false;
+  try {
+    plain.insert(plain.cbegin(), throwing.begin(), throwing.end());
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  assert(thrown);
+  ThrowOnCopy::copies_left = 2;
+  thrown = false;
+  try {
+    stacked.insert(stacked.cbegin(), throwing.begin(), throwing.end());
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  ThrowOnCopy::copies_left = 1 << 20;
+  assert(thrown);
+  assert(plain.size() == 1 && plain.begin()->value == 0);
+  assert(stacked.size() == 1 && stacked.begin()->value == 0);
+}
+
+struct Task {
+  int id;
+  ListHook<> hook;
+  ListHook<true> auto_hook;
+};
+
+struct VirtualTask {
+  virtual ~VirtualTask() = default;
+  std::string name;
+  ListHook<> hook;
+};
+
+struct Labelled {
+  std::string label;
+};
+
+struct HookedBase {
+  int weight = 0;
+  ListHook<> hook;
+};
+
+struct DerivedTask : Labelled, HookedBase {
+  int id = 0;
+};
+
+void TestIntrusiveList() {
+  std::vector<Task> pool(5);
+  for (int i = 0; i < 5; ++i) {
+    pool[i].id = i;
+  }
+  IntrusiveList<Task, &Task::hook> queue;
+  for (Task& task : pool) {
+    queue.push_back(task);
+  }
+  assert(queue.size() == 5 && &queue.front() == &pool[0]);
+  auto iter = queue.erase(queue.iterator_to(pool[2]));
+  assert(iter->id == 3 && !pool[2].hook.is_linked());
+  queue.push_front(pool[2]);
+  std::vector<int> ids;
+  for (const Task& task : queue) {
+    ids.push_back(task.id);
+  }
+  assert((ids == std::vector<int>{2, 0, 1, 3, 4}));
+  IntrusiveList<Task, &Task::hook> other(std::move(queue));
+  assert(queue.empty() && other.size() == 5 && other.back().id == 4);
+  queue.splice(queue.end(), other);
+  assert(other.empty() && queue.size() == 5 && (--queue.end())->id == 4);
+  queue.clear();
+  assert(!pool[0].hook.is_linked());
+
+  IntrusiveList<Task, &Task::auto_hook> watched;
+  watched.push_back(pool[0]);
+  {
+    Task temporary{42, {}, {}};
+    watched.push_back(temporary);
+    assert(watched.size() == 2);
+  }
+  assert(watched.size() == 1 && watched.front().id == 0);
+
+  VirtualTask first, second;
+  first.name = "first";
+  second.name = "second";
+  IntrusiveList<VirtualTask, &VirtualTask::hook> named;
+  named.push_back(first);
+  named.push_front(second);
+  assert(named.front().name == "second" && named.back().name == "first");
+  named.clear();
+
+  //  Хук в базе, которая не первая: смещение считается от HookedBase
+  std::vector<DerivedTask> derived(3);
+  IntrusiveList<DerivedTask, &DerivedTask::hook> chain;
+  for (int i = 0; i < 3; ++i) {
+    derived[i].id = i;
+    chain.push_back(derived[i]);
+  }
+  assert(&chain.front() == &derived[0] && &chain.back() == &derived[2]);
+  assert((++chain.begin())->id == 1);
+  chain.clear();
+}
+
+template <typename Queue>
+void CheckConcurrentQueue(Queue& queue) {
+  const int producers = 2, consumers = 2, items = 20000;
+  std::atomic<long long> sum = 0;
+  std::atomic<int> popped = 0;
+  std::vector<std::thread> workers;
+  for (int id = 0; id < producers; ++id) {
+    workers.emplace_back([&queue, id] {
+      for (int i = 0; i < items; ++i) {
+        queue.push(id * items + i);
+      }
+    });
+  }
+  for (int id = 0; id < consumers; ++id) {
+    workers.emplace_back([&queue, &sum, &popped] {
+      int value = 0;
+      while (popped.load() < producers * items) {
+        if (queue.try_pop(value)) {
+          sum += value;
+          ++popped;
+        }
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  long long total = static_cast<long long>(producers) * items;
+  assert(sum == total * (total - 1) / 2 && queue.empty());
+}
+
+//  Конструктор бросает для каждого седьмого значения
+struct ThrowOnSeventh {
+  int value = 0;
+  ThrowOnSeventh() = default;
+  explicit ThrowOnSeventh(int value)
+      : value(value) {
+    if (value % 7 == 0) {
+      throw std::runtime_error("seventh");
+    }
+  }
+};
+
+void CheckThrowingEmplace() {
+  const int threads = 4, items = 20000;
+  ConcurrentQueue<ThrowOnSeventh> queue;
+  std::atomic<int> failed = 0;
+  std::atomic<long long> sum = 0;
+  std::vector<std::thread> workers;
+  for (int id = 0; id < threads; ++id) {
+    workers.emplace_back([&queue, &failed, &sum, id] {
+      ThrowOnSeventh popped;
+      for (int i = 0; i < items; ++i) {
+        try {
+          queue.emplace(id * items + i);
+        } catch (const std::runtime_error&) {
+          ++failed;
+        }
+        if (i % 2 == 0 && queue.try_pop(popped)) {
+          sum += popped.value;
+        }
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  ThrowOnSeventh popped;
+  while (queue.try_pop(popped)) {
+    sum += popped.value;
+  }
+  long long total = static_cast<long long>(threads) * items;
+  long long sevens = (total - 1) / 7;
+  assert(failed == sevens + 1);
+  assert(sum == total * (total - 1) / 2 - 7 * sevens * (sevens + 1) / 2);
+}
+
+void TestConcurrentQueue() {
+  ConcurrentQueue<std::string> strings;
+  std::string value;
+  assert(!strings.try_pop(value));
+  strings.push("first");
+  strings.emplace(20, 'x');
+  strings.push("left in queue");
+  assert(strings.try_pop(value) && value == "first");
+  assert(strings.try_pop(value) && value == std::string(20, 'x'));
+
+  ConcurrentQueue<int> plain;
+  CheckConcurrentQueue(plain);
+  const size_t size = 1 << 22;
+  static AtomicStackStorage<size> shared;
+  ConcurrentQueue<int, AtomicStackAllocator<int, size>> pooled{
+      AtomicStackAllocator<int, size>(shared)};
+  CheckConcurrentQueue(pooled);
+  CheckThrowingEmplace();
+}
+
+using PmrList = List<int, std::pmr::polymorphic_allocator<int>>;
+
+void FillPmrList(PmrList& list, int count) {
+  for (int i = 0; i < count; ++i) {
+    list.push_back(i);
+  }
+}
+
+void TestMemoryResources() {
+  StackStorage<1000> small;
+  StackStorage<2000> large;
+  MonotonicStackResource<1000> monotonic(small);
+  PooledStackResource<2000> pooled(large);
+  PmrList in_small(&monotonic);
+  PmrList in_large(&pooled);
+  FillPmrList(in_small, 10);
+  FillPmrList(in_large, 10);
+  assert(small.shift > 0 && large.shift > 0);
+  assert(Collect(in_small) == Collect(in_large));
+
+  size_t small_shift = small.shift;
+  in_small.pop_front();
+  in_small.push_back(10);
+  assert(small.shift > small_shift);
+  size_t large_shift = large.shift;
+  in_large.pop_front();
+  in_large.push_back(10);
+  assert(large.shift == large_shift);
+
+  std::pmr::vector<int> numbers({1, 2, 3}, &pooled);
+  assert(numbers.get_allocator().resource() == &pooled);
+  assert(std::pmr::polymorphic_allocator<int>(&monotonic) !=
+         std::pmr::polymorphic_allocator<int>(&pooled));
+  StackStorage<1000>::Marker marker(small);
+  std::pmr::string text(100, 'x', &monotonic);
+  assert(small.shift >= small_shift + 100);
+}
+
+//  Проверяет оба режима: обычную сборку и сборку с -DSTACKSTORAGE_STATS=1
+void TestStorageStats() {
+  static_assert(std::is_empty_v<StackStats<false>>);
+  StackStorage<256> storage;
+  storage.allocate(1, 1);
+  void* aligned = storage.allocate(16, 16);
+  storage.allocate(100, 1);
+  storage.deallocate(aligned, 16);
+  storage.allocate(16, 16);
+  bool overflowed = false;
+  try {
+    storage.allocate(1000, 1);
+  } catch (const std::bad_alloc&) {
+    overflowed = true;
+  }
+  assert(overflowed);
+  std::ostringstream report;
+  storage.report(report);
+#if STACKSTORAGE_STATS
+  assert(storage.stats.allocations == 5 && storage.stats.deallocations == 1);
+  assert(storage.stats.free_list_hits == 1 && storage.stats.overflows == 1);
+  assert(storage.stats.padding == 15 && storage.stats.high_water == 132);
+  assert(storage.stats.histogram[0] == 1 && storage.stats.histogram[4] == 2);
+  assert(storage.stats.histogram[6] == 1 && storage.stats.histogram[9] == 1);
+  assert(report.str().find("high water mark: 132 bytes") != std::string::npos);
+#else
+  assert(report.str().find("disabled") != std::string::npos);
+#endif
+}
+
+void TestSlabAllocator() {
+  const size_t size = 1 << 20;
+  StackStorage<size> storage;
+  SlabStorage<size> slabs(storage);
+  List<int, SlabAllocator<int, size>> list{SlabAllocator<int, size>(slabs)};
+  using MapAllocator = SlabAllocator<std::pair<const int, int>, size>;
+  std::map<int, int, std::less<int>, MapAllocator> map{MapAllocator(slabs)};
+  for (int i = 0; i < 1000; ++i) {
+    list.push_back(i);
+    map[i] = i;
+  }
+  assert(list.size() == 1000 && map.size() == 1000 && map[500] == 500);
+  auto first = list.begin();
+  auto second = first;
+  ++second;
+  assert(reinterpret_cast<char*>(&*second) - reinterpret_cast<char*>(&*first) ==
+         static_cast<ptrdiff_t>(SlabStorage<size>::CLASS_STEP * 2));
+  size_t used = storage.shift;
+  while (list.size() > 0) {
+    list.pop_front();
+  }
+  map.clear();
+  using Big = std::array<char, 200>;
+  List<Big, SlabAllocator<Big, size>> big{SlabAllocator<Big, size>(slabs)};
+  for (int i = 0; i < 200; ++i) {
+    big.push_back(Big());
+  }
+  assert(storage.shift == used);
+  std::vector<int> values = {1, 2, 3};
+  List<int, SlabAllocator<int, size>> bulk(values.begin(), values.end(),
+                                           SlabAllocator<int, size>(slabs));
+  assert(Collect(bulk) == values);
+}
+
+void TestNodeHandles() {
+  const size_t size = 1 << 12;
+  StackStorage<size> storage;
+  using Allocator = StackAllocator<std::string, size>;
+  using Strings = std::vector<std::string>;
+  Strings letters = {"a", "b", "c"};
+  List<std::string, Allocator> source(letters.begin(), letters.end(),
+                                      Allocator(storage));
+  List<std::string, Allocator> target{Allocator(storage)};
+  auto middle = source.begin();
+  ++middle;
+  const std::string* address = &*middle;
+  size_t shift = storage.shift;
+  auto handle = source.extract(middle);
+  assert(handle && handle.value() == "b" && source.size() == 2);
+  auto inserted = target.insert(std::move(handle));
+  assert(handle.empty() && &*inserted == address && storage.shift == shift);
+  handle = target.extract(target.begin());
+  handle.value() = "z";
+  source.insert(source.begin(), std::move(handle));
+  assert((Strings(source.begin(), source.end()) == Strings{"z", "a", "c"}));
+  assert(target.size() == 0 && storage.shift == shift);
+
+  StackStorage<size> other_storage;
+  List<std::string, Allocator> elsewhere{Allocator(other_storage)};
+  elsewhere.insert(source.extract(source.begin()));
+  assert((Strings(elsewhere.begin(), elsewhere.end()) == Strings{"z"}));
+  assert(other_storage.shift > 0 && source.size() == 2);
+  {
+    auto dropped = source.extract(source.begin());
+    assert(dropped.get_allocator() == source.get_allocator());
+  }
+  assert((Strings(source.begin(), source.end()) == Strings{"c"}));
+  List<std::string, Allocator>::node_type empty;
+  assert(source.insert(source.cend(), std::move(empty)) == source.end());
+}
+
+void TestTraversalAndCompact() {
+  const size_t size = 1 << 16;
+  StackStorage<size> storage;
+  List<std::string, StackAllocator<std::string, size>> list{
+      StackAllocator<std::string, size>(storage)};
+  std::vector<std::string> expected;
+  for (int i = 0; i < 200; ++i) {
+    list.push_back(std::to_string(i));
+  }
+  //  Перемешиваем адреса: удаляем каждый второй и вставляем в начало
+  for (int round = 0; round < 3; ++round) {
+    bool odd = false;
+    for (auto iter = list.begin(); iter != list.end(); odd = !odd) {
+      auto current = iter++;
+      if (odd) {
+        list.erase(current);
+      }
+    }
+    for (int i = 0; i < 100; ++i) {
+      list.push_front("r" + std::to_string(round * 100 + i));
+    }
+  }
+  list.for_each([&expected](const std::string& value) {
+    expected.push_back(value);
+  });
+  assert(std::vector<std::string>(list.begin(), list.end()) == expected);
+  size_t shift = storage.shift;
+  list.compact();
+  assert(storage.shift == shift);
+  assert(std::vector<std::string>(list.begin(), list.end()) == expected);
+  for (auto iter = list.begin(); std::next(iter) != list.end(); ++iter) {
+    assert(&*iter < &*std::next(iter));
+  }
+  const auto& view = list;
+  assert(*view.find(expected[7]) == expected[7]);
+  assert(list.find(std::string("missing")) == list.end());
+  list.find(expected[3])->append("!");
+  expected[3].append("!");
+  assert(view.accumulate(size_t(0), [](size_t total, const std::string& value) {
+    return total + value.size();
+  }) == std::accumulate(expected.begin(), expected.end(), size_t(0),
+                        [](size_t total, const std::string& value) {
+                          return total + value.size();
+                        }));
+
+  std::vector<int> values = {5, 1, 4};
+  List<int> numbers(values.begin(), values.end());
+  numbers.for_each([](int& value) { value *= 2; });
+  assert(numbers.accumulate(0) == 20);
+  assert((Collect(numbers) == std::vector<int>{10, 2, 8}));
+  numbers.compact();
+  assert((Collect(numbers) == std::vector<int>{10, 2, 8}));
+}
+
+void TestSkipList() {
+  const size_t size = 1 << 20;
+  StackStorage<size> storage;
+  using Allocator = StackAllocator<int, size>;
+  SkipList<int, std::less<int>, Allocator> list{Allocator(storage)};
+  std::set<int> expected;
+  std::mt19937 generator(7);
+  for (int i = 0; i < 20000; ++i) {
+    int key = static_cast<int>(generator() % 5000);
+    if (generator() % 3 == 0) {
+      assert(list.erase(key) == expected.erase(key));
+    } else {
+      auto [iter, inserted] = list.insert(key);
+      assert(*iter == key && inserted == expected.insert(key).second);
+    }
+  }
+  assert(list.size() == expected.size());
+  assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+  assert(std::equal(list.rbegin(), list.rend(), expected.rbegin(),
+                    expected.rend()));
+  for (int key = -1; key <= 5000; key += 7) {
+    assert(list.contains(key) == expected.contains(key));
+    auto lower = list.lower_bound(key);
+    assert(lower == list.end() ? expected.lower_bound(key) == expected.end()
+                               : *lower == *expected.lower_bound(key));
+    auto upper = list.upper_bound(key);
+    assert(upper == list.end() ? expected.upper_bound(key) == expected.end()
+                               : *upper == *expected.upper_bound(key));
+  }
+  auto iter = list.find(*std::next(expected.begin(), 10));
+  iter = list.erase(iter);
+  assert(*iter == *std::next(expected.begin(), 11));
+  expected.erase(std::next(expected.begin(), 10));
+
+  auto copy = list;
+  auto moved = std::move(list);
+  assert(list.size() == 0 && list.begin() == list.end());
+  assert(std::equal(copy.begin(), copy.end(), expected.begin(), expected.end()));
+  assert(std::equal(moved.rbegin(), moved.rend(), copy.rbegin(), copy.rend()));
+  list.insert(1);
+  list.swap(moved);
+  assert(moved.size() == 1 && *moved.begin() == 1 && *--moved.end() == 1);
+  assert(list.size() == expected.size() && list.contains(*expected.begin()));
+  moved = copy;
+  assert(std::equal(moved.begin(), moved.end(), expected.begin(),
+                    expected.end()));
+
+  SkipList<std::string, std::greater<std::string>> words{"b", "c", "a", "b"};
+  assert(words.size() == 3 && *words.begin() == "c" && *words.rbegin() == "a");
+  assert(words.emplace(3, 'a').second && words.contains("aaa"));
+  words.clear();
+  assert(words.empty() && words.begin() == words.end());
+}
+
+void TestParallelAlgorithms() {
+  const int size = 100000;
+  List<int> list;
+  for (int i = 0; i < size; ++i) {
+    list.push_back(i);
+  }
+  SkipIndex index(list, 4);
+  assert(index.segments() == 4 && *index.segment_begin(1) == size / 4);
+  assert(index.segment_end(3) == list.end());
+  parallel_for_each(index, [](int& value) { value *= 2; });
+  long long sum = parallel_transform_reduce(
+      index, 5LL, std::plus<>(),
+      [](int value) { return static_cast<long long>(value); });
+  assert(sum == 5 + static_cast<long long>(size) * (size - 1));
+  const auto& view = list;
+  SkipIndex tiny(view, 16);
+  assert(tiny.segments() == 16);
+  assert(SkipIndex(view, 0).segments() == 1);
+  List<int> empty;
+  assert(parallel_transform_reduce(SkipIndex(empty, 4), 7, std::plus<>(),
+                                   [](int value) { return value; }) == 7);
+
+  //  Устойчивость: равные ключи сохраняют исходный порядок
+  std::mt19937 generator(11);
+  List<std::pair<int, int>> pairs;
+  std::vector<std::pair<int, int>> expected;
+  for (int i = 0; i < size; ++i) {
+    pairs.push_back({static_cast<int>(generator() % 1000), i});
+    expected.push_back(*pairs.crbegin());
+  }
+  auto by_key = [](const std::pair<int, int>& left,
+                   const std::pair<int, int>& right) {
+    return left.first < right.first;
+  };
+  std::stable_sort(expected.begin(), expected.end(), by_key);
+  for (size_t threads : {1, 3, 8}) {
+    List<std::pair<int, int>> copy = pairs;
+    parallel_sort(copy, threads, by_key);
+    assert(std::equal(copy.begin(), copy.end(), expected.begin(),
+                      expected.end()));
+    assert(std::equal(copy.rbegin(), copy.rend(), expected.rbegin(),
+                      expected.rend()));
+  }
+  std::vector<int> values = {3, 1, 2};
+  List<int> numbers(values.begin(), values.end());
+  parallel_sort(numbers, 4);
+  assert((Collect(numbers) == std::vector<int>{1, 2, 3}));
+}
+
+int main() {
+  TestFreeListReuse();
+  TestStorageSizeClasses();
+  TestHeapFallback();
+  TestAlignment();
+  TestMarker();
+  TestSharedStorages();
+  TestMoveAndSwap();
+  TestSpliceMergeSort();
+  TestEmplace();
+  TestSentinel();
+  TestUnrolledList();
+  TestUnrolledListSplit();
+  TestBulkInsert();
+  TestIntrusiveList();
+  TestConcurrentQueue();
+  TestMemoryResources();
+  TestStorageStats();
+  TestSlabAllocator();
+  TestNodeHandles();
+  TestTraversalAndCompact();
+  TestSkipList();
+  TestParallelAlgorithms();
+  return 0;
+}
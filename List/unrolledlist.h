@@ -0,0 +1,648 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "stackallocator.h"
+
+//  Развёрнутый список: в каждом узле (чанке) до ChunkSize элементов подряд,
+//  поэтому обход промахивается по кэшу раз на чанк, а не на каждый элемент.
+//  Чанки замкнуты в кольцо через sentinel_, как узлы в List.
+//
+//  Стабильность итераторов:
+//  - insert/emplace инвалидируют итераторы на элементы того чанка, куда идёт
+//    вставка (при переполнении чанк делится пополам - тогда и его половины);
+//  - erase инвалидирует итераторы на элементы своего чанка начиная с
+//    удаляемого;
+//  - итераторы других чанков и end() остаются валидными всегда.
+//  Операции, перевязывающие отдельные элементы (splice, merge, sort), здесь
+//  не поддерживаются: элемент не живёт в собственном узле.
+template <typename T, size_t ChunkSize = 32,
+          typename Allocator = std::allocator<T>>
+class UnrolledList {
+  static_assert(ChunkSize > 0, "UnrolledList needs a non-empty chunk");
+
+ private:
+  struct BaseChunk {
+    BaseChunk* previous;
+    BaseChunk* next;
+    size_t count;
+  };
+  struct Chunk : BaseChunk {
+    alignas(T) unsigned char storage[ChunkSize * sizeof(T)];
+    T* values();
+  };
+  using ChunkAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
+  using AllocatorTraits = std::allocator_traits<ChunkAllocator>;
+  [[no_unique_address]] ChunkAllocator allocator_;
+  size_t size_ = 0;
+  BaseChunk sentinel_ = {&sentinel_, &sentinel_, 0};
+  BaseChunk* sentinel() const;
+  void fix_sentinel();
+  Chunk* new_chunk_before(BaseChunk* place);
+  void delete_chunk(BaseChunk* chunk);
+  Chunk* split(Chunk* chunk);
+  template <typename... Args>
+  void append(Args&&... args);
+  template <typename... Args>
+  void place(Chunk* chunk, size_t index, Args&&... args);
+  void fill_copy(const UnrolledList& other);
+  void clear();
+  void swap_chunks(UnrolledList& other);
+
+ public:
+  template <bool is_const>
+  struct basic_iterator {
+    BaseChunk* chunk;
+    size_t index;
+    typedef typename std::conditional<is_const, const T, T>::type value_type;
+    typedef typename std::conditional<is_const, const T&, T&>::type reference;
+    typedef typename std::conditional<is_const, const T*, T*>::type pointer;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    basic_iterator() = default;
+    basic_iterator(BaseChunk* chunk, size_t index);
+    basic_iterator& operator++();
+    basic_iterator operator++(int);
+    basic_iterator& operator--();
+    basic_iterator operator--(int);
+    bool operator==(const basic_iterator& other) const;
+    bool operator!=(const basic_iterator& other) const;
+    reference operator*() const;
+    pointer operator->() const;
+    operator basic_iterator<true>() const;
+  };
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  UnrolledList() = default;
+  UnrolledList(size_t n);
+  UnrolledList(size_t n, const T& element);
+  UnrolledList(const Allocator& allocator);
+  UnrolledList(size_t n, const Allocator& allocator);
+  UnrolledList(size_t n, const T& element, const Allocator& allocator);
+  UnrolledList(const UnrolledList& other);
+  UnrolledList(UnrolledList&& other) noexcept;
+  ~UnrolledList();
+  UnrolledList& operator=(const UnrolledList& other);
+  UnrolledList& operator=(UnrolledList&& other);
+  void swap(UnrolledList& other);
+  Allocator get_allocator() const;
+  size_t size() const;
+  void push_back(const T& element);
+  void push_back(T&& element);
+  void pop_back();
+  void push_front(const T& element);
+  void push_front(T&& element);
+  void pop_front();
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  template <typename... Args>
+  T& emplace_front(Args&&... args);
+  iterator begin();
+  const_iterator begin() const;
+  const_iterator cbegin() const;
+  iterator end();
+  const_iterator end() const;
+  const_iterator cend() const;
+  reverse_iterator rbegin();
+  const_reverse_iterator rbegin() const;
+  const_reverse_iterator crbegin() const;
+  reverse_iterator rend();
+  const_reverse_iterator rend() const;
+  const_reverse_iterator crend() const;
+  iterator insert(const const_iterator& iter, const T& element);
+  iterator insert(const const_iterator& iter, T&& element);
+  template <typename... Args>
+  iterator emplace(const const_iterator& iter, Args&&... args);
+  iterator erase(const const_iterator& iter);
+};
+
+template <typename T, size_t ChunkSize, typename Allocator>
+T* UnrolledList<T, ChunkSize, Allocator>::Chunk::values() {
+  return std::launder(reinterpret_cast<T*>(storage));
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::BaseChunk*
+UnrolledList<T, ChunkSize, Allocator>::sentinel() const {
+  return const_cast<BaseChunk*>(&sentinel_);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::fix_sentinel() {
+  if (size_ == 0) {
+    sentinel_.previous = &sentinel_;
+    sentinel_.next = &sentinel_;
+  } else {
+    sentinel_.next->previous = &sentinel_;
+    sentinel_.previous->next = &sentinel_;
+  }
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::Chunk*
+UnrolledList<T, ChunkSize, Allocator>::new_chunk_before(BaseChunk* place) {
+  Chunk* chunk = AllocatorTraits::allocate(allocator_, 1);
+  chunk->count = 0;
+  chunk->previous = place->previous;
+  chunk->next = place;
+  place->previous->next = chunk;
+  place->previous = chunk;
+  return chunk;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::delete_chunk(BaseChunk* chunk) {
+  chunk->previous->next = chunk->next;
+  chunk->next->previous = chunk->previous;
+  AllocatorTraits::deallocate(allocator_, static_cast<Chunk*>(chunk), 1);
+}
+
+//  Переносит верхнюю половину полного чанка в новый чанк сразу после него.
+//  Если T копируется (перемещение не noexcept) и копия бросает, новый чанк
+//  удаляется и исходный остаётся нетронутым
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::Chunk*
+UnrolledList<T, ChunkSize, Allocator>::split(Chunk* chunk) {
+  Chunk* upper = new_chunk_before(chunk->next);
+  size_t half = ChunkSize / 2;
+  T* from = chunk->values();
+  T* to = upper->values();
+  try {
+    for (size_t i = half; i < chunk->count; ++i) {
+      ::new (static_cast<void*>(to + upper->count))
+          T(std::move_if_noexcept(from[i]));
+      ++upper->count;
+    }
+  } catch (...) {
+    std::destroy(to, to + upper->count);
+    delete_chunk(upper);
+    throw;
+  }
+  std::destroy(from + half, from + chunk->count);
+  chunk->count = half;
+  return upper;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <typename... Args>
+void UnrolledList<T, ChunkSize, Allocator>::append(Args&&... args) {
+  BaseChunk* last = sentinel_.previous;
+  bool fresh = (last == &sentinel_ || last->count == ChunkSize);
+  Chunk* chunk = fresh ? new_chunk_before(&sentinel_) : static_cast<Chunk*>(last);
+  try {
+    ::new (static_cast<void*>(chunk->values() + chunk->count))
+        T(std::forward<Args>(args)...);
+  } catch (...) {
+    if (fresh) {
+      delete_chunk(chunk);
+    }
+    throw;
+  }
+  ++chunk->count;
+  ++size_;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::fill_copy(const UnrolledList& other) {
+  try {
+    for (const T& element : other) {
+      append(element);
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::clear() {
+  BaseChunk* chunk = sentinel_.next;
+  while (chunk != &sentinel_) {
+    BaseChunk* next = chunk->next;
+    Chunk* full = static_cast<Chunk*>(chunk);
+    std::destroy(full->values(), full->values() + full->count);
+    AllocatorTraits::deallocate(allocator_, full, 1);
+    chunk = next;
+  }
+  sentinel_.previous = &sentinel_;
+  sentinel_.next = &sentinel_;
+  size_ = 0;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::swap_chunks(UnrolledList& other) {
+  std::swap(size_, other.size_);
+  std::swap(sentinel_, other.sentinel_);
+  fix_sentinel();
+  other.fix_sentinel();
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::basic_iterator(
+    BaseChunk* chunk, size_t index)
+    : chunk(chunk),
+      index(index) {
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+typename UnrolledList<T, ChunkSize, Allocator>::template basic_iterator<is_const>&
+UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator++() {
+  if (++index >= chunk->count) {
+    chunk = chunk->next;
+    index = 0;
+  }
+  return *this;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+typename UnrolledList<T, ChunkSize, Allocator>::template basic_iterator<is_const>
+UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator++(int) {
+  basic_iterator copy = basic_iterator(*this);
+  ++*this;
+  return copy;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+typename UnrolledList<T, ChunkSize, Allocator>::template basic_iterator<is_const>&
+UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator--() {
+  if (index == 0) {
+    chunk = chunk->previous;
+    index = chunk->count;
+  }
+  --index;
+  return *this;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+typename UnrolledList<T, ChunkSize, Allocator>::template basic_iterator<is_const>
+UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator--(int) {
+  basic_iterator copy = basic_iterator(*this);
+  --*this;
+  return copy;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+bool UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator==(
+    const basic_iterator& other) const {
+  return chunk == other.chunk && index == other.index;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+bool UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator!=(
+    const basic_iterator& other) const {
+  return !(*this == other);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+typename UnrolledList<T, ChunkSize, Allocator>::template basic_iterator<
+    is_const>::reference
+UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator*()
+    const {
+  return static_cast<Chunk*>(chunk)->values()[index];
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+typename UnrolledList<T, ChunkSize, Allocator>::template basic_iterator<
+    is_const>::pointer
+UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator->()
+    const {
+  return static_cast<Chunk*>(chunk)->values() + index;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <bool is_const>
+UnrolledList<T, ChunkSize, Allocator>::basic_iterator<is_const>::operator
+    UnrolledList<T, ChunkSize, Allocator>::basic_iterator<true>() const {
+  return basic_iterator<true>(chunk, index);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>::UnrolledList(size_t n)
+    : UnrolledList(n, Allocator()) {
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>::UnrolledList(size_t n, const T& element)
+    : UnrolledList(n, element, Allocator()) {
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>::UnrolledList(const Allocator& allocator)
+    : allocator_(allocator) {
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>::UnrolledList(size_t n,
+                                                    const Allocator& allocator)
+    : allocator_(allocator) {
+  try {
+    for (size_t i = 0; i < n; ++i) {
+      append();
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>::UnrolledList(size_t n, const T& element,
+                                                    const Allocator& allocator)
+    : allocator_(allocator) {
+  try {
+    for (size_t i = 0; i < n; ++i) {
+      append(element);
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>::UnrolledList(const UnrolledList& other)
+    : allocator_(AllocatorTraits::select_on_container_copy_construction(
+          other.allocator_)) {
+  fill_copy(other);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>::UnrolledList(UnrolledList&& other) noexcept
+    : allocator_(std::move(other.allocator_)) {
+  swap_chunks(other);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>::~UnrolledList() {
+  clear();
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>&
+UnrolledList<T, ChunkSize, Allocator>::operator=(const UnrolledList& other) {
+  if (this == &other) {
+    return *this;
+  }
+  constexpr bool propagate =
+      AllocatorTraits::propagate_on_container_copy_assignment::value;
+  UnrolledList temporary(propagate ? other.get_allocator() : get_allocator());
+  temporary.fill_copy(other);
+  clear();
+  if constexpr (propagate) {
+    allocator_ = other.allocator_;
+  }
+  swap_chunks(temporary);
+  return *this;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+UnrolledList<T, ChunkSize, Allocator>&
+UnrolledList<T, ChunkSize, Allocator>::operator=(UnrolledList&& other) {
+  if (this == &other) {
+    return *this;
+  }
+  clear();
+  if constexpr (AllocatorTraits::propagate_on_container_move_assignment::
+                    value) {
+    allocator_ = std::move(other.allocator_);
+    swap_chunks(other);
+  } else {
+    if (allocator_ == other.allocator_) {
+      swap_chunks(other);
+    } else {
+      for (T& element : other) {
+        append(std::move(element));
+      }
+      other.clear();
+    }
+  }
+  return *this;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::swap(UnrolledList& other) {
+  if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+    std::swap(allocator_, other.allocator_);
+  }
+  swap_chunks(other);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+Allocator UnrolledList<T, ChunkSize, Allocator>::get_allocator() const {
+  return allocator_;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+size_t UnrolledList<T, ChunkSize, Allocator>::size() const {
+  return size_;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::push_back(const T& element) {
+  append(element);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::push_back(T&& element) {
+  append(std::move(element));
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::pop_back() {
+  erase(--end());
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::push_front(const T& element) {
+  emplace(begin(), element);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::push_front(T&& element) {
+  emplace(begin(), std::move(element));
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void UnrolledList<T, ChunkSize, Allocator>::pop_front() {
+  erase(begin());
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <typename... Args>
+T& UnrolledList<T, ChunkSize, Allocator>::emplace_back(Args&&... args) {
+  append(std::forward<Args>(args)...);
+  return *--end();
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <typename... Args>
+T& UnrolledList<T, ChunkSize, Allocator>::emplace_front(Args&&... args) {
+  return *emplace(begin(), std::forward<Args>(args)...);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::iterator
+UnrolledList<T, ChunkSize, Allocator>::begin() {
+  return iterator(sentinel_.next, 0);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::const_iterator
+UnrolledList<T, ChunkSize, Allocator>::begin() const {
+  return const_iterator(sentinel_.next, 0);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::const_iterator
+UnrolledList<T, ChunkSize, Allocator>::cbegin() const {
+  return const_iterator(sentinel_.next, 0);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::iterator
+UnrolledList<T, ChunkSize, Allocator>::end() {
+  return iterator(&sentinel_, 0);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::const_iterator
+UnrolledList<T, ChunkSize, Allocator>::end() const {
+  return const_iterator(sentinel(), 0);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::const_iterator
+UnrolledList<T, ChunkSize, Allocator>::cend() const {
+  return const_iterator(sentinel(), 0);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::reverse_iterator
+UnrolledList<T, ChunkSize, Allocator>::rbegin() {
+  return reverse_iterator(end());
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::const_reverse_iterator
+UnrolledList<T, ChunkSize, Allocator>::rbegin() const {
+  return crbegin();
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::const_reverse_iterator
+UnrolledList<T, ChunkSize, Allocator>::crbegin() const {
+  return const_reverse_iterator(cend());
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::reverse_iterator
+UnrolledList<T, ChunkSize, Allocator>::rend() {
+  return reverse_iterator(begin());
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::const_reverse_iterator
+UnrolledList<T, ChunkSize, Allocator>::rend() const {
+  return crend();
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::const_reverse_iterator
+UnrolledList<T, ChunkSize, Allocator>::crend() const {
+  return const_reverse_iterator(cbegin());
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::iterator
+UnrolledList<T, ChunkSize, Allocator>::insert(const const_iterator& iter,
+                                              const T& element) {
+  return emplace(iter, element);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::iterator
+UnrolledList<T, ChunkSize, Allocator>::insert(const const_iterator& iter,
+                                              T&& element) {
+  return emplace(iter, std::move(element));
+}
+
+//  Значение строится в свободном слоте за концом чанка и лишь потом
+//  поворачивается на место, так что бросивший конструктор не оставляет в
+//  чанке дыры. В полный чанк оно сначала строится отдельно: split перемещает
+//  половину элементов, а args могут ссылаться на любой из них
+template <typename T, size_t ChunkSize, typename Allocator>
+template <typename... Args>
+typename UnrolledList<T, ChunkSize, Allocator>::iterator
+UnrolledList<T, ChunkSize, Allocator>::emplace(const const_iterator& iter,
+                                               Args&&... args) {
+  if (iter.chunk == &sentinel_) {
+    append(std::forward<Args>(args)...);
+    return --end();
+  }
+  Chunk* chunk = static_cast<Chunk*>(iter.chunk);
+  size_t index = iter.index;
+  if (chunk->count < ChunkSize) {
+    place(chunk, index, std::forward<Args>(args)...);
+    return iterator(chunk, index);
+  }
+  T value(std::forward<Args>(args)...);
+  Chunk* upper = split(chunk);
+  if (index > chunk->count) {
+    index -= chunk->count;
+    chunk = upper;
+  }
+  place(chunk, index, std::move(value));
+  return iterator(chunk, index);
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+template <typename... Args>
+void UnrolledList<T, ChunkSize, Allocator>::place(Chunk* chunk, size_t index,
+                                                  Args&&... args) {
+  T* values = chunk->values();
+  ::new (static_cast<void*>(values + chunk->count))
+      T(std::forward<Args>(args)...);
+  ++chunk->count;
+  ++size_;
+  std::rotate(values + index, values + chunk->count - 1,
+              values + chunk->count);
+}
+
+//  Опустевший чанк сразу освобождается, поэтому пустых чанков в кольце нет
+template <typename T, size_t ChunkSize, typename Allocator>
+typename UnrolledList<T, ChunkSize, Allocator>::iterator
+UnrolledList<T, ChunkSize, Allocator>::erase(const const_iterator& iter) {
+  Chunk* chunk = static_cast<Chunk*>(iter.chunk);
+  T* values = chunk->values();
+  std::move(values + iter.index + 1, values + chunk->count, values + iter.index);
+  std::destroy_at(values + chunk->count - 1);
+  --chunk->count;
+  --size_;
+  if (chunk->count == 0) {
+    BaseChunk* next = chunk->next;
+    delete_chunk(chunk);
+    return iterator(next, 0);
+  }
+  if (iter.index == chunk->count) {
+    return iterator(chunk->next, 0);
+  }
+  return iterator(chunk, iter.index);
+}